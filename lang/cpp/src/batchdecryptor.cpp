@@ -0,0 +1,228 @@
+/*
+  batchdecryptor.cpp - decrypt many messages in parallel
+  Copyright (C) 2026 g10 Code GmbH
+
+  This file is part of GPGME++.
+
+  GPGME++ is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Library General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+  GPGME++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Library General Public License for more details.
+
+  You should have received a copy of the GNU Library General Public License
+  along with GPGME++; see the file COPYING.LIB.  If not, write to the
+  Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+  Boston, MA 02110-1301, USA.
+*/
+
+#ifdef HAVE_CONFIG_H
+ #include "config.h"
+#endif
+
+#include "batchdecryptor.h"
+#include "contextpool.h"
+#include "data.h"
+
+#include <gpgme.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace GpgME;
+
+namespace
+{
+
+struct Job {
+    const Data *cipherText;
+    Data *plainText;
+    std::promise<DecryptionResult> promise;
+};
+
+struct Worker {
+    // Protects jobs.
+    std::mutex mutex;
+    std::deque<Job> jobs;
+    std::thread thread;
+};
+
+}
+
+class BatchDecryptor::Private
+{
+public:
+    Private(Context::DecryptionFlags f, unsigned int maxQ)
+        : flags(f), maxQueued(maxQ), queued(0), running(0),
+          nextWorker(0), stopping(false)
+    {
+    }
+
+    void run(unsigned int self);
+    Job takeJob(unsigned int self);
+
+    std::unique_ptr<ContextPool> pool;
+    Error poolError;
+    const Context::DecryptionFlags flags;
+    const unsigned int maxQueued;
+
+    std::vector<std::unique_ptr<Worker> > workers;
+
+    // Protects the counters and the stopping flag.  When both locks
+    // are needed, this one has to be taken before a worker's mutex.
+    std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::condition_variable spaceAvailable;
+    std::condition_variable finished;
+    unsigned int queued;
+    unsigned int running;
+    unsigned int nextWorker;
+    bool stopping;
+};
+
+// Take a job, preferring the oldest one of our own queue and
+// otherwise stealing the newest one of another worker.  The caller
+// must have reserved a job by decrementing queued, so this always
+// finds one.
+Job BatchDecryptor::Private::takeJob(unsigned int self)
+{
+    const unsigned int n = workers.size();
+    for (;;) {
+        for (unsigned int i = 0; i < n; ++i) {
+            Worker &w = *workers[(self + i) % n];
+            std::lock_guard<std::mutex> lock(w.mutex);
+            if (w.jobs.empty()) {
+                continue;
+            }
+            Job job;
+            if (i == 0) {
+                job = std::move(w.jobs.front());
+                w.jobs.pop_front();
+            } else {
+                job = std::move(w.jobs.back());
+                w.jobs.pop_back();
+            }
+            return job;
+        }
+        std::this_thread::yield();
+    }
+}
+
+void BatchDecryptor::Private::run(unsigned int self)
+{
+    Error err = poolError;
+    std::unique_ptr<Context> ctx;
+    if (pool) {
+        ctx = pool->checkout(&err);
+    }
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            workAvailable.wait(lock, [this] { return queued || stopping; });
+            if (!queued) {
+                break;
+            }
+            --queued;
+            ++running;
+        }
+        spaceAvailable.notify_one();
+
+        Job job = takeJob(self);
+        if (ctx) {
+            job.promise.set_value(ctx->decrypt(*job.cipherText, *job.plainText, flags));
+        } else {
+            job.promise.set_value(DecryptionResult(err));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --running;
+            if (!queued && !running) {
+                finished.notify_all();
+            }
+        }
+    }
+
+    if (ctx) {
+        pool->checkin(std::move(ctx));
+    }
+}
+
+BatchDecryptor::BatchDecryptor(const Context &templ,
+                               Context::DecryptionFlags flags,
+                               unsigned int threads,
+                               unsigned int maxQueued)
+{
+    if (!threads) {
+        threads = std::thread::hardware_concurrency();
+        if (!threads) {
+            threads = 1;
+        }
+    }
+    if (!maxQueued) {
+        maxQueued = 2 * threads;
+    }
+
+    d.reset(new Private(flags, maxQueued));
+    d->pool = ContextPool::create(templ, threads, &d->poolError);
+
+    for (unsigned int i = 0; i < threads; ++i) {
+        d->workers.emplace_back(new Worker);
+    }
+    for (unsigned int i = 0; i < threads; ++i) {
+        d->workers[i]->thread = std::thread(&Private::run, d.get(), i);
+    }
+}
+
+BatchDecryptor::~BatchDecryptor()
+{
+    {
+        std::lock_guard<std::mutex> lock(d->mutex);
+        d->stopping = true;
+    }
+    d->workAvailable.notify_all();
+    for (auto &w : d->workers) {
+        w->thread.join();
+    }
+}
+
+std::future<DecryptionResult> BatchDecryptor::add(const Data &cipherText, Data &plainText)
+{
+    Job job;
+    job.cipherText = &cipherText;
+    job.plainText = &plainText;
+    std::future<DecryptionResult> future = job.promise.get_future();
+
+    {
+        std::unique_lock<std::mutex> lock(d->mutex);
+        d->spaceAvailable.wait(lock, [this] { return d->queued < d->maxQueued; });
+        Worker &w = *d->workers[d->nextWorker++ % d->workers.size()];
+        {
+            std::lock_guard<std::mutex> wlock(w.mutex);
+            w.jobs.push_back(std::move(job));
+        }
+        ++d->queued;
+    }
+    d->workAvailable.notify_one();
+
+    return future;
+}
+
+void BatchDecryptor::waitForFinished()
+{
+    std::unique_lock<std::mutex> lock(d->mutex);
+    d->finished.wait(lock, [this] { return !d->queued && !d->running; });
+}
+
+unsigned int BatchDecryptor::numThreads() const
+{
+    return d->workers.size();
+}
@@ -0,0 +1,93 @@
+/*
+  batchdecryptor.h - decrypt many messages in parallel
+  Copyright (C) 2026 g10 Code GmbH
+
+  This file is part of GPGME++.
+
+  GPGME++ is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Library General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+  GPGME++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Library General Public License for more details.
+
+  You should have received a copy of the GNU Library General Public License
+  along with GPGME++; see the file COPYING.LIB.  If not, write to the
+  Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+  Boston, MA 02110-1301, USA.
+*/
+
+// -*- c++ -*-
+#ifndef __GPGMEPP_BATCHDECRYPTOR_H__
+#define __GPGMEPP_BATCHDECRYPTOR_H__
+
+#include "global.h"
+#include "context.h"
+#include "decryptionresult.h"
+
+#include <future>
+#include <memory>
+
+namespace GpgME
+{
+
+class Data;
+
+/** Decrypts many messages in parallel.
+ *
+ * A BatchDecryptor runs a number of worker threads, each with its own
+ * context taken from a ContextPool configured like the template
+ * context.  Jobs added with add() are distributed over the workers;
+ * idle workers steal jobs queued for busy ones.  If the number of
+ * queued jobs reaches the queue limit, add() blocks until a worker has
+ * taken a job.
+ *
+ * Destroying the BatchDecryptor waits for all queued jobs.
+ */
+class GPGMEPP_EXPORT BatchDecryptor
+{
+public:
+    /** Create a BatchDecryptor whose contexts are configured like
+     * @p templ.
+     *
+     * @param templ The template context; it is not referenced after
+     *              the constructor returns.
+     * @param flags The flags used for all decryptions.
+     * @param threads The number of worker threads; 0 uses the number
+     *                of cores of the host.
+     * @param maxQueued The maximum number of jobs waiting for a worker;
+     *                  0 uses twice the number of worker threads.
+     */
+    explicit BatchDecryptor(const Context &templ,
+                            Context::DecryptionFlags flags = Context::DecryptNone,
+                            unsigned int threads = 0,
+                            unsigned int maxQueued = 0);
+    ~BatchDecryptor();
+
+    /** Queue the decryption of @p cipherText into @p plainText.
+     *
+     * Blocks while the queue is full.  The returned future becomes
+     * ready when the job has been processed.  Both data objects must
+     * stay alive and must not be used by the caller until then. */
+    std::future<DecryptionResult> add(const Data &cipherText, Data &plainText);
+
+    /** Wait until all queued jobs have been processed. */
+    void waitForFinished();
+
+    /** The number of worker threads. */
+    unsigned int numThreads() const;
+
+private:
+    BatchDecryptor(const BatchDecryptor &) = delete;
+    BatchDecryptor &operator=(const BatchDecryptor &) = delete;
+
+    class Private;
+    std::unique_ptr<Private> d;
+};
+
+} // namespace GpgME
+
+#endif // __GPGMEPP_BATCHDECRYPTOR_H__
@@ -1320,6 +1320,23 @@ Error Context::cancelPendingOperation()
     return Error(gpgme_cancel_async(d->ctx));
 }
 
+Context::OperationStats Context::operationStats() const
+{
+    OperationStats stats;
+    if (const gpgme_op_stats_t s = gpgme_op_stats(d->ctx)) {
+        stats.bytesIn = s->bytes_in;
+        stats.bytesOut = s->bytes_out;
+        stats.readCalls = s->read_calls;
+        stats.writeCalls = s->write_calls;
+        stats.wakeups = s->wakeups;
+        stats.statusLines = s->status_lines;
+        stats.spawns = s->spawns;
+        stats.spawnMicroseconds = s->spawn_usec;
+        stats.totalMicroseconds = s->total_usec;
+    }
+    return stats;
+}
+
 bool Context::poll()
 {
     gpgme_error_t e = GPG_ERR_NO_ERROR;
@@ -56,10 +56,12 @@ class EncryptionResult;
 class VfsMountResult;
 
 class EngineInfo;
+class ContextPool;
 
 class GPGMEPP_EXPORT Context
 {
     explicit Context(gpgme_ctx_t);
+    friend class ::GpgME::ContextPool;
 public:
     //using GpgME::Protocol;
 
@@ -459,6 +461,21 @@ public:
     GpgME::Error lastError() const;
     GpgME::Error cancelPendingOperation();
 
+    /** Statistics about an operation.  See gpgme_op_stats. */
+    struct OperationStats {
+        unsigned long long bytesIn = 0;
+        unsigned long long bytesOut = 0;
+        unsigned long readCalls = 0;
+        unsigned long writeCalls = 0;
+        unsigned long wakeups = 0;
+        unsigned long statusLines = 0;
+        unsigned long spawns = 0;
+        unsigned long long spawnMicroseconds = 0;
+        unsigned long long totalMicroseconds = 0;
+    };
+    /** Returns the statistics of the current or last operation. */
+    OperationStats operationStats() const;
+
     class Private;
     const Private *impl() const
     {
@@ -0,0 +1,84 @@
+/*
+  contextpool.cpp - wraps a gpgme context pool
+  Copyright (C) 2026 g10 Code GmbH
+
+  This file is part of GPGME++.
+
+  GPGME++ is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Library General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+  GPGME++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Library General Public License for more details.
+
+  You should have received a copy of the GNU Library General Public License
+  along with GPGME++; see the file COPYING.LIB.  If not, write to the
+  Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+  Boston, MA 02110-1301, USA.
+*/
+
+#ifdef HAVE_CONFIG_H
+ #include "config.h"
+#endif
+
+#include "contextpool.h"
+#include "context.h"
+#include "context_p.h"
+
+#include <gpgme.h>
+
+using namespace GpgME;
+
+ContextPool::ContextPool(gpgme_ctx_pool_t pool)
+    : mPool(pool)
+{
+}
+
+ContextPool::~ContextPool()
+{
+    gpgme_ctx_pool_release(mPool);
+}
+
+std::unique_ptr<ContextPool> ContextPool::create(const Context &templ,
+                                                 unsigned int size,
+                                                 Error *err)
+{
+    gpgme_ctx_pool_t pool = nullptr;
+    const gpgme_error_t e = gpgme_ctx_pool_new(&pool, templ.impl()->ctx, size);
+    if (err) {
+        *err = Error(e);
+    }
+    if (e) {
+        return std::unique_ptr<ContextPool>();
+    }
+    return std::unique_ptr<ContextPool>(new ContextPool(pool));
+}
+
+std::unique_ptr<Context> ContextPool::checkout(Error *err)
+{
+    gpgme_ctx_t ctx = nullptr;
+    const gpgme_error_t e = gpgme_ctx_pool_get(mPool, &ctx);
+    if (err) {
+        *err = Error(e);
+    }
+    if (e) {
+        return std::unique_ptr<Context>();
+    }
+    return std::unique_ptr<Context>(new Context(ctx));
+}
+
+void ContextPool::checkin(std::unique_ptr<Context> ctx)
+{
+    if (!ctx) {
+        return;
+    }
+    // Take the gpgme context away from the wrapper so that deleting
+    // the wrapper does not release it.
+    gpgme_ctx_t c = ctx->impl()->ctx;
+    ctx->impl()->ctx = nullptr;
+    ctx.reset();
+    gpgme_ctx_pool_put(mPool, c);
+}
@@ -0,0 +1,80 @@
+/*
+  contextpool.h - wraps a gpgme context pool
+  Copyright (C) 2026 g10 Code GmbH
+
+  This file is part of GPGME++.
+
+  GPGME++ is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Library General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+  GPGME++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Library General Public License for more details.
+
+  You should have received a copy of the GNU Library General Public License
+  along with GPGME++; see the file COPYING.LIB.  If not, write to the
+  Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+  Boston, MA 02110-1301, USA.
+*/
+
+// -*- c++ -*-
+#ifndef __GPGMEPP_CONTEXTPOOL_H__
+#define __GPGMEPP_CONTEXTPOOL_H__
+
+#include "global.h"
+#include "error.h"
+
+#include <memory>
+
+namespace GpgME
+{
+
+class Context;
+
+/** A thread-safe pool of contexts with the same configuration.
+ *
+ * Contexts taken from the pool with checkout() are configured like the
+ * template context the pool was created with (protocol, armor, key
+ * list mode, engine info, providers, ...).  Returning them with
+ * checkin() drops all results, signers and notations and resets the
+ * configuration, so that they can be reused without paying the cost of
+ * creating a new context.
+ */
+class GPGMEPP_EXPORT ContextPool
+{
+public:
+    /** Create a pool of contexts configured like @p templ.
+     *
+     * @p size contexts are created right away and up to @p size
+     * returned contexts are kept for reuse.  @p templ is not
+     * referenced after this call.
+     *
+     * Returns a null pointer on error.
+     */
+    static std::unique_ptr<ContextPool> create(const Context &templ,
+                                               unsigned int size,
+                                               Error *err = nullptr);
+    ~ContextPool();
+
+    /** Take a context from the pool.  A new context is created if the
+     * pool has no idle context.  Returns a null pointer on error. */
+    std::unique_ptr<Context> checkout(Error *err = nullptr);
+
+    /** Return a context obtained from checkout() to the pool.  The
+     * last operation on the context must have been finished. */
+    void checkin(std::unique_ptr<Context> ctx);
+
+private:
+    explicit ContextPool(gpgme_ctx_pool_t pool);
+    ContextPool(const ContextPool &) = delete;
+    ContextPool &operator=(const ContextPool &) = delete;
+
+    gpgme_ctx_pool_t mPool;
+};
+
+} // namespace GpgME
+
+#endif // __GPGMEPP_CONTEXTPOOL_H__
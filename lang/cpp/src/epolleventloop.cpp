@@ -0,0 +1,303 @@
+/*
+  epolleventloop.cpp - epoll based EventLoopInteractor
+  Copyright (C) 2026 g10 Code GmbH
+
+  This file is part of GPGME++.
+
+  GPGME++ is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Library General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+  GPGME++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Library General Public License for more details.
+
+  You should have received a copy of the GNU Library General Public License
+  along with GPGME++; see the file COPYING.LIB.  If not, write to the
+  Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+  Boston, MA 02110-1301, USA.
+*/
+
+#ifdef HAVE_CONFIG_H
+ #include "config.h"
+#endif
+
+#include "epolleventloop.h"
+#include "data.h"
+
+#include <gpgme.h>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#ifdef HAVE_SYS_EPOLL_H
+# include <sys/epoll.h>
+# include <unistd.h>
+# include <cerrno>
+#endif
+
+using namespace GpgME;
+
+namespace
+{
+
+// A file descriptor watched by epoll.  gpgme normally uses a pipe end
+// per direction, but nothing forbids watching one fd both ways.
+struct Watch {
+    Watch() : id(0), readers(0), writers(0) {}
+    // Identifies this registration in epoll events.  It is never
+    // reused, so events for an fd which was closed and reopened while
+    // processing a batch of events can be told apart.
+    unsigned long long id;
+    unsigned int readers;
+    unsigned int writers;
+};
+
+struct Tag {
+    int fd;
+    EventLoopInteractor::Direction dir;
+};
+
+}
+
+class EpollEventLoop::Private
+{
+public:
+    Private() : epfd(-1), nextId(1) {}
+
+    Error update(int fd, Watch &w, bool added);
+
+    int epfd;
+    Error error;
+    unsigned long long nextId;
+    std::map<int, Watch> watches;
+    std::map<unsigned long long, int> fdById;
+
+    std::map<Context *, DoneHandler> pending;
+    std::vector<std::pair<DoneHandler, Error> > finished;
+};
+
+Error EpollEventLoop::Private::update(int fd, Watch &w, bool added)
+{
+#ifdef HAVE_SYS_EPOLL_H
+    struct epoll_event ev;
+    ev.events = 0;
+    if (w.readers) {
+        ev.events |= EPOLLIN;
+    }
+    if (w.writers) {
+        ev.events |= EPOLLOUT;
+    }
+    ev.data.u64 = w.id;
+    if (!ev.events) {
+        if (epoll_ctl(epfd, EPOLL_CTL_DEL, fd, &ev) && errno != EBADF && errno != ENOENT) {
+            return Error::fromSystemError();
+        }
+        return Error();
+    }
+    if (epoll_ctl(epfd, added ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &ev)) {
+        return Error::fromSystemError();
+    }
+    return Error();
+#else
+    (void)fd;
+    (void)w;
+    (void)added;
+    return Error::fromCode(GPG_ERR_NOT_SUPPORTED);
+#endif
+}
+
+EpollEventLoop::EpollEventLoop()
+    : EventLoopInteractor(), d(new Private)
+{
+#ifdef HAVE_SYS_EPOLL_H
+    d->epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (d->epfd == -1) {
+        d->error = Error::fromSystemError();
+    }
+#else
+    d->error = Error::fromCode(GPG_ERR_NOT_SUPPORTED);
+#endif
+}
+
+EpollEventLoop::~EpollEventLoop()
+{
+#ifdef HAVE_SYS_EPOLL_H
+    if (d->epfd != -1) {
+        close(d->epfd);
+    }
+#endif
+    delete d;
+}
+
+Error EpollEventLoop::error() const
+{
+    return d->error;
+}
+
+Error EpollEventLoop::start(Context *ctx, const Starter &starter, const DoneHandler &done)
+{
+    if (d->error.code()) {
+        return d->error;
+    }
+    if (!ctx || d->pending.count(ctx)) {
+        return Error::fromCode(GPG_ERR_INV_VALUE);
+    }
+    manage(ctx);
+    // Register the handler first; gpgme may report that the operation
+    // is done before the starter returns.
+    d->pending[ctx] = done;
+    const Error err = starter(ctx);
+    if (err.code()) {
+        d->pending.erase(ctx);
+    }
+    return err;
+}
+
+Error EpollEventLoop::startDecryption(Context *ctx, const Data &cipherText, Data &plainText,
+                                      const DoneHandler &done, Context::DecryptionFlags flags)
+{
+    return start(ctx, [&cipherText, &plainText, flags](Context *c) {
+        return c->startDecryption(cipherText, plainText, flags);
+    }, done);
+}
+
+unsigned int EpollEventLoop::pendingOperations() const
+{
+    return d->pending.size() + d->finished.size();
+}
+
+unsigned int EpollEventLoop::processEvents(int timeout)
+{
+#ifdef HAVE_SYS_EPOLL_H
+    if (d->finished.empty() && !d->watches.empty()) {
+        struct epoll_event events[64];
+        int n;
+        do {
+            n = epoll_wait(d->epfd, events, 64, timeout);
+        } while (n == -1 && errno == EINTR);
+        if (n == -1) {
+            d->error = Error::fromSystemError();
+        }
+
+        for (int i = 0; i < n; ++i) {
+            // Earlier callbacks may have removed the watch.
+            const auto idIt = d->fdById.find(events[i].data.u64);
+            if (idIt == d->fdById.end()) {
+                continue;
+            }
+            const int fd = idIt->second;
+            const bool readable = events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR);
+            const bool writable = events[i].events & (EPOLLOUT | EPOLLERR);
+            if (readable && d->watches[fd].readers) {
+                actOn(fd, Read);
+            }
+            const auto it = d->watches.find(fd);
+            if (writable && it != d->watches.end() && it->second.id == events[i].data.u64
+                    && it->second.writers) {
+                actOn(fd, Write);
+            }
+        }
+    }
+#else
+    (void)timeout;
+#endif
+
+    // Call the handlers only now, so that they can start new
+    // operations without re-entering gpgme.
+    std::vector<std::pair<DoneHandler, Error> > finished;
+    finished.swap(d->finished);
+    for (auto &f : finished) {
+        if (f.first) {
+            f.first(f.second);
+        }
+    }
+    return finished.size();
+}
+
+Error EpollEventLoop::run()
+{
+    while (pendingOperations()) {
+        if (d->error.code()) {
+            return d->error;
+        }
+        // Without a watch, processEvents would return at once and we
+        // would never get anywhere.
+        if (d->finished.empty() && d->watches.empty()) {
+            return Error::fromCode(GPG_ERR_INV_STATE);
+        }
+        processEvents(-1);
+    }
+    return Error();
+}
+
+void *EpollEventLoop::registerWatcher(int fd, Direction dir, bool &ok)
+{
+    ok = false;
+    if (d->error.code()) {
+        return nullptr;
+    }
+
+    const bool added = !d->watches.count(fd);
+    Watch &w = d->watches[fd];
+    if (added) {
+        w.id = d->nextId++;
+        d->fdById[w.id] = fd;
+    }
+    (dir == Read ? w.readers : w.writers)++;
+    if (d->update(fd, w, added).code()) {
+        (dir == Read ? w.readers : w.writers)--;
+        if (added) {
+            d->fdById.erase(w.id);
+            d->watches.erase(fd);
+        }
+        return nullptr;
+    }
+
+    ok = true;
+    return new Tag{fd, dir};
+}
+
+void EpollEventLoop::unregisterWatcher(void *tag)
+{
+    Tag *const t = static_cast<Tag *>(tag);
+    if (!t) {
+        return;
+    }
+    const auto it = d->watches.find(t->fd);
+    if (it != d->watches.end()) {
+        Watch &w = it->second;
+        (t->dir == Read ? w.readers : w.writers)--;
+        d->update(t->fd, w, false);
+        if (!w.readers && !w.writers) {
+            d->fdById.erase(w.id);
+            d->watches.erase(it);
+        }
+    }
+    delete t;
+}
+
+void EpollEventLoop::operationStartEvent(Context *)
+{
+}
+
+void EpollEventLoop::nextTrustItemEvent(Context *, const TrustItem &)
+{
+}
+
+void EpollEventLoop::nextKeyEvent(Context *, const Key &)
+{
+}
+
+void EpollEventLoop::operationDoneEvent(Context *context, const Error &e)
+{
+    const auto it = d->pending.find(context);
+    if (it == d->pending.end()) {
+        return;
+    }
+    d->finished.emplace_back(std::move(it->second), e);
+    d->pending.erase(it);
+}
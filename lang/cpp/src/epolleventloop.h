@@ -0,0 +1,195 @@
+/*
+  epolleventloop.h - epoll based EventLoopInteractor
+  Copyright (C) 2026 g10 Code GmbH
+
+  This file is part of GPGME++.
+
+  GPGME++ is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Library General Public
+  License as published by the Free Software Foundation; either
+  version 2 of the License, or (at your option) any later version.
+
+  GPGME++ is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Library General Public License for more details.
+
+  You should have received a copy of the GNU Library General Public License
+  along with GPGME++; see the file COPYING.LIB.  If not, write to the
+  Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+  Boston, MA 02110-1301, USA.
+*/
+
+// -*- c++ -*-
+#ifndef __GPGMEPP_EPOLLEVENTLOOP_H__
+#define __GPGMEPP_EPOLLEVENTLOOP_H__
+
+#include "eventloopinteractor.h"
+#include "context.h"
+#include "decryptionresult.h"
+#include "error.h"
+
+#include <functional>
+
+namespace GpgME
+{
+
+class Data;
+
+/*! \file epolleventloop.h
+    \brief A ready-made EventLoopInteractor based on epoll
+
+    \c EpollEventLoop runs any number of asynchronous operations on
+    different contexts in the thread calling \c processEvents() or
+    \c run().  Each operation is started with a handler which is
+    called with the final error once the operation has finished.
+
+    \verbatim
+    EpollEventLoop loop;
+    for (auto &job : jobs) {
+        loop.startDecryption(job.ctx, job.cipher, job.plain,
+                             [&job](const Error &err) { ... });
+    }
+    loop.run();
+    \endverbatim
+
+    Handlers are called from \c processEvents() after gpgme has
+    finished with the operation, so they may start the next operation
+    on the same context.
+
+    If the compiler supports C++20 coroutines, \c decryptAsync()
+    returns an awaitable for use with \c co_await.  The coroutine is
+    resumed from \c processEvents().
+
+    Like all EventLoopInteractors, an \c EpollEventLoop is a
+    singleton and must only be used from one thread.  It is only
+    available on systems with epoll; elsewhere \c error() returns
+    \c GPG_ERR_NOT_SUPPORTED.
+*/
+class GPGMEPP_EXPORT EpollEventLoop : public EventLoopInteractor
+{
+public:
+    typedef std::function<void(const Error &)> DoneHandler;
+    typedef std::function<Error(Context *)> Starter;
+
+    EpollEventLoop();
+    ~EpollEventLoop();
+
+    /** The error encountered while setting up the event loop. */
+    Error error() const;
+
+    /** Let @p ctx be managed by the event loop, call @p starter to
+     * start an asynchronous operation on it and call @p done once the
+     * operation has finished.  If @p starter fails, its error is
+     * returned and @p done is not called. */
+    Error start(Context *ctx, const Starter &starter, const DoneHandler &done);
+
+    /** Start decrypting @p cipherText into @p plainText on @p ctx.
+     * The result is available with Context::decryptionResult() when
+     * @p done is called. */
+    Error startDecryption(Context *ctx, const Data &cipherText, Data &plainText,
+                          const DoneHandler &done,
+                          Context::DecryptionFlags flags = Context::DecryptNone);
+
+    /** The number of started operations whose handler has not been
+     * called yet. */
+    unsigned int pendingOperations() const;
+
+    /** Wait up to @p timeout milliseconds (-1 for no limit) for
+     * activity, process it and call the handlers of all finished
+     * operations.  Returns the number of handlers called.  Returns at
+     * once if no file descriptor is watched; if waiting fails, the
+     * error is available with error(). */
+    unsigned int processEvents(int timeout = -1);
+
+    /** Process events until no operation is pending.  Returns
+     * GPG_ERR_INV_STATE if operations are pending but there is
+     * nothing to wait for, and error() if the event loop is not
+     * usable. */
+    Error run();
+
+protected:
+    void *registerWatcher(int fd, Direction dir, bool &ok) override;
+    void unregisterWatcher(void *tag) override;
+
+    void operationStartEvent(Context *context) override;
+    void nextTrustItemEvent(Context *context, const TrustItem &item) override;
+    void nextKeyEvent(Context *context, const Key &key) override;
+    void operationDoneEvent(Context *context, const Error &e) override;
+
+private:
+    EpollEventLoop(const EpollEventLoop &) = delete;
+    EpollEventLoop &operator=(const EpollEventLoop &) = delete;
+
+    class Private;
+    Private *const d;
+};
+
+} // namespace GpgME
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+# include <coroutine>
+
+namespace GpgME
+{
+
+/** Awaitable returned by decryptAsync(). */
+class DecryptionAwaiter
+{
+public:
+    DecryptionAwaiter(EpollEventLoop &loop, Context &ctx,
+                      const Data &cipherText, Data &plainText,
+                      Context::DecryptionFlags flags)
+        : mLoop(loop), mCtx(ctx), mCipherText(cipherText),
+          mPlainText(plainText), mFlags(flags)
+    {
+    }
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    bool await_suspend(std::coroutine_handle<> handle)
+    {
+        mStartError = mLoop.startDecryption(&mCtx, mCipherText, mPlainText,
+                                            [handle](const Error &) { handle.resume(); },
+                                            mFlags);
+        return !mStartError.code();
+    }
+
+    DecryptionResult await_resume() const
+    {
+        if (mStartError.code()) {
+            return DecryptionResult(mStartError);
+        }
+        return mCtx.decryptionResult();
+    }
+
+private:
+    EpollEventLoop &mLoop;
+    Context &mCtx;
+    const Data &mCipherText;
+    Data &mPlainText;
+    const Context::DecryptionFlags mFlags;
+    Error mStartError;
+};
+
+/** Decrypt @p cipherText into @p plainText on @p ctx using @p loop.
+ *
+ * \verbatim
+ * DecryptionResult res = co_await decryptAsync(loop, ctx, cipher, plain);
+ * \endverbatim
+ */
+inline DecryptionAwaiter decryptAsync(EpollEventLoop &loop, Context &ctx,
+                                      const Data &cipherText, Data &plainText,
+                                      Context::DecryptionFlags flags = Context::DecryptNone)
+{
+    return DecryptionAwaiter(loop, ctx, cipherText, plainText, flags);
+}
+
+} // namespace GpgME
+
+#endif // __cpp_impl_coroutine
+
+#endif // __GPGMEPP_EPOLLEVENTLOOP_H__
@@ -28,6 +28,9 @@
 struct gpgme_context;
 typedef gpgme_context *gpgme_ctx_t;
 
+struct gpgme_ctx_pool;
+typedef gpgme_ctx_pool *gpgme_ctx_pool_t;
+
 struct gpgme_data;
 typedef gpgme_data *gpgme_data_t;
 
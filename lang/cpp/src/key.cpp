@@ -94,30 +94,24 @@ unsigned int Key::numSubkeys() const
 
 std::vector<UserID> Key::userIDs() const
 {
-    if (!key) {
-        return std::vector<UserID>();
-    }
-
-    std::vector<UserID> v;
-    v.reserve(numUserIDs());
-    for (gpgme_user_id_t uid = key->uids ; uid ; uid = uid->next) {
-        v.push_back(UserID(key, uid));
-    }
-    return v;
+    const KeyItemRange<UserID> range = userIDRange();
+    return std::vector<UserID>(range.begin(), range.end());
 }
 
 std::vector<Subkey> Key::subkeys() const
 {
-    if (!key) {
-        return std::vector<Subkey>();
-    }
+    const KeyItemRange<Subkey> range = subkeyRange();
+    return std::vector<Subkey>(range.begin(), range.end());
+}
 
-    std::vector<Subkey> v;
-    v.reserve(numSubkeys());
-    for (gpgme_sub_key_t subkey = key->subkeys ; subkey ; subkey = subkey->next) {
-        v.push_back(Subkey(key, subkey));
-    }
-    return v;
+KeyItemRange<UserID> Key::userIDRange() const
+{
+    return KeyItemRange<UserID>(UserID(key, key ? key->uids : nullptr));
+}
+
+KeyItemRange<Subkey> Key::subkeyRange() const
+{
+    return KeyItemRange<Subkey>(Subkey(key, key ? key->subkeys : nullptr));
 }
 
 Key::OwnerTrust Key::ownerTrust() const
@@ -444,6 +438,11 @@ Key Subkey::parent() const
     return Key(key);
 }
 
+void Subkey::advance()
+{
+    subkey = subkey->next;
+}
+
 const char *Subkey::keyID() const
 {
     return subkey ? subkey->keyid : nullptr ;
@@ -623,6 +622,11 @@ Key UserID::parent() const
     return Key(key);
 }
 
+void UserID::advance()
+{
+    uid = uid->next;
+}
+
 UserID::Signature UserID::signature(unsigned int index) const
 {
     return Signature(key, uid, index);
@@ -642,16 +646,13 @@ unsigned int UserID::numSignatures() const
 
 std::vector<UserID::Signature> UserID::signatures() const
 {
-    if (!uid) {
-        return std::vector<Signature>();
-    }
+    const KeyItemRange<Signature> range = signatureRange();
+    return std::vector<Signature>(range.begin(), range.end());
+}
 
-    std::vector<Signature> v;
-    v.reserve(numSignatures());
-    for (gpgme_key_sig_t sig = uid->signatures ; sig ; sig = sig->next) {
-        v.push_back(Signature(key, uid, sig));
-    }
-    return v;
+KeyItemRange<UserID::Signature> UserID::signatureRange() const
+{
+    return KeyItemRange<Signature>(Signature(key, uid, uid ? uid->signatures : nullptr));
 }
 
 const char *UserID::id() const
@@ -773,6 +774,11 @@ UserID UserID::Signature::parent() const
     return UserID(key, uid);
 }
 
+void UserID::Signature::advance()
+{
+    sig = sig->next;
+}
+
 const char *UserID::Signature::signerKeyID() const
 {
     return sig ? sig->keyid : nullptr ;
@@ -1088,7 +1094,7 @@ std::ostream &operator<<(std::ostream &os, const Key &key)
            << "\n origin:     " << key.origin()
            << "\n updated:    " << key.lastUpdate()
            << "\n uids:\n";
-        const std::vector<UserID> uids = key.userIDs();
+        const KeyItemRange<UserID> uids = key.userIDRange();
         std::copy(uids.begin(), uids.end(),
                   std::ostream_iterator<UserID>(os, "\n"));
     }
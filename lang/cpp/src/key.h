@@ -34,6 +34,7 @@
 
 #include <vector>
 #include <algorithm>
+#include <iterator>
 #include <string>
 
 namespace GpgME
@@ -47,6 +48,110 @@ class TofuInfo;
 
 typedef std::shared_ptr< std::remove_pointer<gpgme_key_t>::type > shared_gpgme_key_t;
 
+//
+// class KeyItemIterator
+//
+
+/*!
+  A forward iterator over the subkeys or user IDs of a key or over the
+  signatures of a user ID.
+
+  Unlike the vectors returned by Key::subkeys(), Key::userIDs(), and
+  UserID::signatures() iterating does not allocate.  operator* returns
+  a copy of the current item, which only shares the key, so it stays
+  valid when the iterator is incremented or destroyed.  operator->
+  accesses the current item without copying it.
+*/
+template <typename T>
+class KeyItemIterator
+{
+public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const T *pointer;
+    typedef T reference;
+
+    KeyItemIterator() : item() {}
+    explicit KeyItemIterator(const T &first) : item(first) {}
+
+    reference operator*() const
+    {
+        return item;
+    }
+    pointer operator->() const
+    {
+        return &item;
+    }
+
+    KeyItemIterator &operator++()
+    {
+        item.advance();
+        return *this;
+    }
+    KeyItemIterator operator++(int)
+    {
+        KeyItemIterator tmp(*this);
+        item.advance();
+        return tmp;
+    }
+
+    bool operator==(const KeyItemIterator &other) const
+    {
+        return item.rawItem() == other.item.rawItem();
+    }
+    bool operator!=(const KeyItemIterator &other) const
+    {
+        return !operator==(other);
+    }
+
+private:
+    T item;
+};
+
+//
+// class KeyItemRange
+//
+
+/*!
+  A range of KeyItemIterators, e.g. for use in a range-based for loop:
+
+  @code
+  for (const UserID &uid : key.userIDRange()) {
+      ...
+  }
+  @endcode
+
+  The range shares the key, thus it stays valid if the key is destroyed.
+*/
+template <typename T>
+class KeyItemRange
+{
+public:
+    typedef KeyItemIterator<T> iterator;
+    typedef KeyItemIterator<T> const_iterator;
+
+    KeyItemRange() : first() {}
+    explicit KeyItemRange(T first) : first(std::move(first)) {}
+
+    iterator begin() const
+    {
+        return iterator(first);
+    }
+    iterator end() const
+    {
+        return iterator();
+    }
+
+    bool empty() const
+    {
+        return first.isNull();
+    }
+
+private:
+    T first;
+};
+
 //
 // class Key
 //
@@ -62,6 +167,8 @@ public:
     /* implicit */ Key(const Null &);
     Key(const shared_gpgme_key_t &key);
     Key(gpgme_key_t key, bool acquireRef);
+    Key(const Key &other) = default;
+    Key(Key &&other) = default;
 
     static const Null null;
 
@@ -93,6 +200,11 @@ public:
     std::vector<UserID> userIDs() const;
     std::vector<Subkey> subkeys() const;
 
+    /*! Same as userIDs() without creating a vector. */
+    KeyItemRange<UserID> userIDRange() const;
+    /*! Same as subkeys() without creating a vector. */
+    KeyItemRange<Subkey> subkeyRange() const;
+
     bool isRevoked() const;
     bool isExpired() const;
     bool isDisabled() const;
@@ -221,6 +333,8 @@ public:
     Subkey();
     Subkey(const shared_gpgme_key_t &key, gpgme_sub_key_t subkey);
     Subkey(const shared_gpgme_key_t &key, unsigned int idx);
+    Subkey(const Subkey &other) = default;
+    Subkey(Subkey &&other) = default;
 
     const Subkey &operator=(Subkey other)
     {
@@ -318,6 +432,13 @@ public:
     const char *keyGrip() const;
 
 private:
+    friend class KeyItemIterator<Subkey>;
+    void advance();
+    gpgme_sub_key_t rawItem() const
+    {
+        return subkey;
+    }
+
     shared_gpgme_key_t key;
     gpgme_sub_key_t subkey;
 };
@@ -334,6 +455,8 @@ public:
     UserID();
     UserID(const shared_gpgme_key_t &key, gpgme_user_id_t uid);
     UserID(const shared_gpgme_key_t &key, unsigned int idx);
+    UserID(const UserID &other) = default;
+    UserID(UserID &&other) = default;
 
     const UserID &operator=(UserID other)
     {
@@ -358,6 +481,8 @@ public:
     unsigned int numSignatures() const;
     Signature signature(unsigned int index) const;
     std::vector<Signature> signatures() const;
+    /*! Same as signatures() without creating a vector. */
+    KeyItemRange<Signature> signatureRange() const;
 
     const char *id() const;
     const char *name() const;
@@ -414,6 +539,13 @@ public:
      * @returns the last update time. */
     time_t lastUpdate() const;
 private:
+    friend class KeyItemIterator<UserID>;
+    void advance();
+    gpgme_user_id_t rawItem() const
+    {
+        return uid;
+    }
+
     shared_gpgme_key_t key;
     gpgme_user_id_t uid;
 };
@@ -430,6 +562,8 @@ public:
     Signature();
     Signature(const shared_gpgme_key_t &key, gpgme_user_id_t uid, gpgme_key_sig_t sig);
     Signature(const shared_gpgme_key_t &key, gpgme_user_id_t uid, unsigned int idx);
+    Signature(const Signature &other) = default;
+    Signature(Signature &&other) = default;
 
     const Signature &operator=(Signature other)
     {
@@ -488,6 +622,13 @@ public:
     std::vector<GpgME::Notation> notations() const;
 
 private:
+    friend class KeyItemIterator<Signature>;
+    void advance();
+    gpgme_key_sig_t rawItem() const
+    {
+        return sig;
+    }
+
     shared_gpgme_key_t key;
     gpgme_user_id_t uid;
     gpgme_key_sig_t sig;
@@ -0,0 +1,208 @@
+/*
+    run-batchdecrypt.cpp
+
+    This file is part of GpgMEpp's test suite.
+    Copyright (c) 2026 g10 Code GmbH
+
+    QGpgME is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License,
+    version 2, as published by the Free Software Foundation.
+
+    QGpgME is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+    In addition, as a special exception, the copyright holders give
+    permission to link the code of this program with any edition of
+    the Qt library by Trolltech AS, Norway (or with modified versions
+    of Qt that use the same license as Qt), and distribute linked
+    combinations including the two.  You must obey the GNU General
+    Public License in all respects for all of the code used other than
+    Qt.  If you modify this file, you may extend this exception to
+    your version of the file, but you are not obligated to do so.  If
+    you do not wish to do so, delete this exception statement from
+    your version.
+*/
+#ifdef HAVE_CONFIG_H
+ #include "config.h"
+#endif
+
+#include "context.h"
+#include "data.h"
+#include "batchdecryptor.h"
+#include "decryptionresult.h"
+#include "interfaces/passphraseprovider.h"
+
+#include <future>
+#include <memory>
+#include <iostream>
+#include <vector>
+
+using namespace GpgME;
+static int
+show_usage (int ex)
+{
+  fputs ("usage: run-batchdecrypt [options] FILE...\n\n"
+         "Options:\n"
+         "  --verbose        run in verbose mode\n"
+         "  --openpgp        use the OpenPGP protocol (default)\n"
+         "  --cms            use the CMS protocol\n"
+         "  --loopback       use a loopback pinentry\n"
+         "  --threads N      use N worker threads\n"
+         "  --queue N        queue at most N jobs\n"
+         "  --repeat N       decrypt each FILE N times\n"
+         , stderr);
+  exit (ex);
+}
+
+namespace
+{
+class LoopbackProvider : public PassphraseProvider
+{
+public:
+    char *getPassphrase(const char *, const char *, bool, bool &) override
+    {
+        return strdup("abc");
+    }
+};
+}
+
+int
+main (int argc, char **argv)
+{
+    int last_argc = -1;
+    Protocol protocol = OpenPGP;
+    unsigned int threads = 0;
+    unsigned int queue = 0;
+    int repeats = 1;
+    bool verbose = false;
+    bool loopback = false;
+
+    if (argc)
+    { argc--; argv++; }
+
+    while (argc && last_argc != argc )
+    {
+        last_argc = argc;
+        if (!strcmp (*argv, "--"))
+        {
+            argc--; argv++;
+            break;
+        }
+        else if (!strcmp (*argv, "--help"))
+            show_usage (0);
+        else if (!strcmp (*argv, "--verbose"))
+        {
+            verbose = true;
+            argc--; argv++;
+        }
+        else if (!strcmp (*argv, "--openpgp"))
+        {
+            protocol = OpenPGP;
+            argc--; argv++;
+        }
+        else if (!strcmp (*argv, "--cms"))
+        {
+            protocol = CMS;
+            argc--; argv++;
+        }
+        else if (!strcmp (*argv, "--loopback"))
+        {
+            loopback = true;
+            argc--; argv++;
+        }
+        else if (!strcmp (*argv, "--threads"))
+        {
+            argc--; argv++;
+            if (!argc)
+                show_usage (1);
+            threads = atoi (*argv);
+            argc--; argv++;
+        }
+        else if (!strcmp (*argv, "--queue"))
+        {
+            argc--; argv++;
+            if (!argc)
+                show_usage (1);
+            queue = atoi (*argv);
+            argc--; argv++;
+        }
+        else if (!strcmp (*argv, "--repeat"))
+        {
+            argc--; argv++;
+            if (!argc)
+                show_usage (1);
+            repeats = atoi (*argv);
+            argc--; argv++;
+        }
+        else if (!strncmp (*argv, "--", 2))
+            show_usage (1);
+    }
+
+    if (argc < 1 || repeats < 1)
+        show_usage (1);
+
+    GpgME::initializeLibrary();
+
+    auto ctx = std::unique_ptr<Context> (Context::createForProtocol(protocol));
+    if (!ctx) {
+        std::cerr << "Failed to get Context";
+        return -1;
+    }
+    LoopbackProvider provider;
+    if (loopback) {
+        ctx->setPinentryMode(Context::PinentryLoopback);
+        ctx->setPassphraseProvider(&provider);
+    }
+
+    const unsigned int njobs = argc * repeats;
+    std::vector<std::FILE *> files;
+    std::vector<Data> cipher;
+    std::vector<Data> plain(njobs);
+    for (unsigned int i = 0; i < njobs; i++) {
+        std::FILE *fp = fopen (argv[i % argc], "rb");
+        if (!fp) {
+            std::cerr << "Failed to open " << argv[i % argc] << std::endl;
+            exit (1);
+        }
+        files.push_back(fp);
+        cipher.push_back(Data(fp));
+    }
+    std::vector<std::future<DecryptionResult> > results;
+    int failed = 0;
+    {
+        BatchDecryptor batch(*ctx, Context::DecryptNone, threads, queue);
+        std::cout << "Threads: " << batch.numThreads() << std::endl;
+
+        // Add all jobs first so that a failing item in the middle of
+        // the batch runs concurrently with the others.
+        for (unsigned int i = 0; i < njobs; i++) {
+            results.push_back(batch.add(cipher[i], plain[i]));
+        }
+        batch.waitForFinished();
+
+        for (unsigned int i = 0; i < njobs; i++) {
+            const DecryptionResult result = results[i].get();
+            std::cout << argv[i % argc] << ": Err:" << result.error();
+            if (result.error()) {
+                failed++;
+            } else {
+                std::cout << " Plain:" << plain[i].toString().size();
+            }
+            std::cout << std::endl;
+            if (verbose) {
+                std::cout << result << std::endl;
+            }
+        }
+    }
+
+    for (std::FILE *fp : files) {
+        fclose (fp);
+    }
+    return failed ? 1 : 0;
+}
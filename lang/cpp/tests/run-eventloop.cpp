@@ -0,0 +1,224 @@
+/*
+    run-eventloop.cpp
+
+    This file is part of GpgMEpp's test suite.
+    Copyright (c) 2026 g10 Code GmbH
+
+    QGpgME is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License,
+    version 2, as published by the Free Software Foundation.
+
+    QGpgME is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+    In addition, as a special exception, the copyright holders give
+    permission to link the code of this program with any edition of
+    the Qt library by Trolltech AS, Norway (or with modified versions
+    of Qt that use the same license as Qt), and distribute linked
+    combinations including the two.  You must obey the GNU General
+    Public License in all respects for all of the code used other than
+    Qt.  If you modify this file, you may extend this exception to
+    your version of the file, but you are not obligated to do so.  If
+    you do not wish to do so, delete this exception statement from
+    your version.
+*/
+#ifdef HAVE_CONFIG_H
+ #include "config.h"
+#endif
+
+#include "context.h"
+#include "data.h"
+#include "epolleventloop.h"
+#include "decryptionresult.h"
+#include "interfaces/passphraseprovider.h"
+
+#include <memory>
+#include <iostream>
+#include <vector>
+
+using namespace GpgME;
+static int
+show_usage (int ex)
+{
+  fputs ("usage: run-eventloop [options] FILE...\n\n"
+         "Options:\n"
+         "  --verbose        run in verbose mode\n"
+         "  --openpgp        use the OpenPGP protocol (default)\n"
+         "  --cms            use the CMS protocol\n"
+         "  --loopback       use a loopback pinentry\n"
+         "  --repeat N       decrypt each FILE N times\n"
+         , stderr);
+  exit (ex);
+}
+
+namespace
+{
+class LoopbackProvider : public PassphraseProvider
+{
+public:
+    char *getPassphrase(const char *, const char *, bool, bool &) override
+    {
+        return strdup("abc");
+    }
+};
+
+// One file decrypted REPEATS times on its own context.  The next run
+// is started from the done handler of the previous one.
+struct Job {
+    const char *fname;
+    std::unique_ptr<Context> ctx;
+    std::FILE *fp;
+    Data cipher;
+    Data plain;
+    int left;
+};
+}
+
+static int failed;
+static bool verbose;
+
+static void
+start_job (EpollEventLoop &loop, Job &job)
+{
+    job.cipher.rewind();
+    job.plain = Data();
+    job.left--;
+    const Error err = loop.startDecryption(job.ctx.get(), job.cipher, job.plain,
+                                           [&loop, &job](const Error &e) {
+        std::cout << job.fname << ": Err:" << e;
+        if (e) {
+            failed++;
+        } else {
+            std::cout << " Plain:" << job.plain.toString().size();
+        }
+        std::cout << std::endl;
+        if (verbose) {
+            std::cout << job.ctx->decryptionResult() << std::endl;
+        }
+        if (job.left) {
+            start_job (loop, job);
+        }
+    });
+    if (err) {
+        std::cout << job.fname << ": Start Err:" << err << std::endl;
+        failed++;
+    }
+}
+
+int
+main (int argc, char **argv)
+{
+    int last_argc = -1;
+    Protocol protocol = OpenPGP;
+    int repeats = 1;
+    bool loopback = false;
+
+    if (argc)
+    { argc--; argv++; }
+
+    while (argc && last_argc != argc )
+    {
+        last_argc = argc;
+        if (!strcmp (*argv, "--"))
+        {
+            argc--; argv++;
+            break;
+        }
+        else if (!strcmp (*argv, "--help"))
+            show_usage (0);
+        else if (!strcmp (*argv, "--verbose"))
+        {
+            verbose = true;
+            argc--; argv++;
+        }
+        else if (!strcmp (*argv, "--openpgp"))
+        {
+            protocol = OpenPGP;
+            argc--; argv++;
+        }
+        else if (!strcmp (*argv, "--cms"))
+        {
+            protocol = CMS;
+            argc--; argv++;
+        }
+        else if (!strcmp (*argv, "--loopback"))
+        {
+            loopback = true;
+            argc--; argv++;
+        }
+        else if (!strcmp (*argv, "--repeat"))
+        {
+            argc--; argv++;
+            if (!argc)
+                show_usage (1);
+            repeats = atoi (*argv);
+            argc--; argv++;
+        }
+        else if (!strncmp (*argv, "--", 2))
+            show_usage (1);
+    }
+
+    if (argc < 1 || repeats < 1)
+        show_usage (1);
+
+    GpgME::initializeLibrary();
+
+    EpollEventLoop loop;
+    if (loop.error()) {
+        std::cerr << "Failed to set up the event loop: " << loop.error() << std::endl;
+        return 1;
+    }
+
+    // The event loop processes an empty set of operations at once.
+    if (loop.processEvents(-1) || loop.run()) {
+        std::cerr << "Unexpected result of an idle event loop" << std::endl;
+        return 1;
+    }
+
+    LoopbackProvider provider;
+    std::vector<Job> jobs(argc);
+    for (int i = 0; i < argc; i++) {
+        Job &job = jobs[i];
+        job.fname = argv[i];
+        job.ctx = std::unique_ptr<Context> (Context::createForProtocol(protocol));
+        if (!job.ctx) {
+            std::cerr << "Failed to get Context";
+            return -1;
+        }
+        if (loopback) {
+            job.ctx->setPinentryMode(Context::PinentryLoopback);
+            job.ctx->setPassphraseProvider(&provider);
+        }
+        job.fp = fopen (job.fname, "rb");
+        if (!job.fp) {
+            std::cerr << "Failed to open " << job.fname << std::endl;
+            exit (1);
+        }
+        job.cipher = Data(job.fp);
+        job.left = repeats;
+    }
+
+    // Start all files before running the loop, so that they are
+    // decrypted concurrently.
+    for (auto &job : jobs) {
+        start_job (loop, job);
+    }
+    std::cout << "Pending: " << loop.pendingOperations() << std::endl;
+
+    const Error err = loop.run();
+    if (err) {
+        std::cerr << "Event loop failed: " << err << std::endl;
+        failed++;
+    }
+
+    for (auto &job : jobs) {
+        fclose (job.fp);
+    }
+    return failed ? 1 : 0;
+}
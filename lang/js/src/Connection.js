@@ -201,6 +201,7 @@ class Answer{
     constructor (message){
         this._operation = message.operation;
         this._expected = message.expected;
+        this._requests = message.requests;
         this._response_b64 = null;
     }
 
@@ -240,12 +241,28 @@ class Answer{
         if (this._response_b64 === null){
             return gpgme_error('CONN_UNEXPECTED_ANSWER');
         }
-        let _decodedResponse = JSON.parse(atob(this._response_b64));
+        return this._processResponse(JSON.parse(atob(this._response_b64)),
+            this.operation, this.expected, this._requests);
+    }
+
+    /**
+     * Verifies and decodes one answer object of gpgme-json. For a 'batch'
+     * operation, the answers to the bundled requests are processed each
+     * on its own, so that a failed request does not affect the others.
+     * @param {Object} _decodedResponse The parsed answer
+     * @param {String} operation The operation of the request
+     * @param {String} expected The expected format of the payload
+     * @param {Array<GPGME_Message>} requests The bundled requests of a
+     * 'batch' operation
+     * @returns {Object|GPGME_Error} The readable gnupg answer
+     * @private
+     */
+    _processResponse (_decodedResponse, operation, expected, requests){
         let _response = {
             format: 'ascii'
         };
         let messageKeys = Object.keys(_decodedResponse);
-        let poa = permittedOperations[this.operation].answer;
+        let poa = permittedOperations[operation].answer;
         if (messageKeys.length === 0){
             return gpgme_error('CONN_UNEXPECTED_ANSWER');
         }
@@ -264,6 +281,13 @@ class Answer{
             case 'base64': {
                 break;
             }
+            case 'responses': {
+                // processed per request below
+                if (operation !== 'batch'){
+                    return gpgme_error('CONN_UNEXPECTED_ANSWER');
+                }
+                break;
+            }
             case 'msg': {
                 if (_decodedResponse.type === 'error'){
                     return (gpgme_error('GNUPG_ERROR', _decodedResponse.msg));
@@ -291,11 +315,11 @@ class Answer{
                     if (_decodedResponse.base64 === true
                         && poa.payload[key] === 'string'
                     ) {
-                        if (this.expected === 'uint8'){
+                        if (expected === 'uint8'){
                             _response[key] = atobArray(_decodedResponse[key]);
                             _response.format = 'uint8';
 
-                        } else if (this.expected === 'base64'){
+                        } else if (expected === 'base64'){
                             _response[key] = _decodedResponse[key];
                             _response.format = 'base64';
 
@@ -315,6 +339,27 @@ class Answer{
                 break;
             } }
         }
+        if (operation === 'batch'){
+            // The answers are in the same order as the requests.
+            const responses = _decodedResponse.responses;
+            if (!Array.isArray(responses)
+                || !Array.isArray(requests)
+                || responses.length !== requests.length
+            ){
+                return gpgme_error('CONN_UNEXPECTED_ANSWER');
+            }
+            _response.responses = [];
+            for (let i=0; i < responses.length; i++){
+                if (!responses[i] || typeof (responses[i]) !== 'object'){
+                    _response.responses.push(
+                        gpgme_error('CONN_UNEXPECTED_ANSWER'));
+                } else {
+                    _response.responses.push(this._processResponse(
+                        responses[i], requests[i].operation,
+                        requests[i].expected));
+                }
+            }
+        }
         return _response;
     }
 }
@@ -141,26 +141,34 @@ class GPGME_Key {
             if (!me._data.fingerprint){
                 reject(gpgme_error('KEY_INVALID'));
             }
-            let msg = createMessage('keylist');
-            msg.setParameter('sigs', true);
-            msg.setParameter('keys', me._data.fingerprint);
-            msg.post().then(function (result){
-                if (result.keys.length === 1){
+            // The Key and its secret state are fetched in one round trip.
+            let msg = createMessage('batch');
+            let keylist = createMessage('keylist');
+            keylist.setParameter('sigs', true);
+            keylist.setParameter('keys', me._data.fingerprint);
+            let secret = createMessage('keylist');
+            secret.setParameter('keys', me._data.fingerprint);
+            secret.setParameter('secret', true);
+            msg.setParameter('requests', [keylist, secret]);
+            msg.post().then(function (answer){
+                const result = answer.responses[0];
+                if (result instanceof Error){
+                    reject(gpgme_error('GNUPG_ERROR'), result);
+                } else if (answer.responses[1] instanceof Error){
+                    reject(answer.responses[1]);
+                } else if (result.keys.length === 1){
                     const newdata = validateKeyData(
                         me._data.fingerprint, result.keys[0]);
                     if (newdata instanceof Error){
                         reject(gpgme_error('KEY_INVALID'));
                     } else {
+                        const secretKeys = answer.responses[1].keys;
                         me._data = newdata;
-                        me.getGnupgSecretState().then(function (){
-                            me.getArmor().then(function (){
-                                resolve(me);
-                            }, function (error){
-                                reject(error);
-                            });
-                        }, function (error){
-                            reject(error);
-                        });
+                        me._data.hasSecret = Boolean(
+                            secretKeys &&
+                            secretKeys.length === 1 &&
+                            secretKeys[0].secret === true);
+                        resolve(me);
                     }
                 } else {
                     reject(gpgme_error('KEY_NOKEY'));
@@ -65,56 +65,51 @@ export class GPGME_Keyring {
             if (search === true){
                 msg.setParameter('locate', true);
             }
-            msg.post().then(function (result){
-                let resultset = [];
-                if (result.keys.length === 0){
-                    resolve([]);
-                } else {
-                    let secondrequest;
-                    if (prepare_sync === true) {
-                        secondrequest = function () {
-                            let msg2 = createMessage('keylist');
-                            if (pattern){
-                                msg2.setParameter('keys', pattern);
-                            }
-                            msg2.setParameter('secret', true);
-                            return msg2.post();
-                        };
-                    } else {
-                        secondrequest = function () {
-                            return Promise.resolve(true);
-                        };
+            let request = msg;
+            if (prepare_sync === true) {
+                // The secret keys are listed in the same round trip.
+                let msg2 = createMessage('keylist');
+                if (pattern){
+                    msg2.setParameter('keys', pattern);
+                }
+                msg2.setParameter('secret', true);
+                request = createMessage('batch');
+                request.setParameter('requests', [msg, msg2]);
+            }
+            request.post().then(function (answer){
+                let result = answer;
+                let secret = null;
+                if (prepare_sync === true) {
+                    result = answer.responses[0];
+                    secret = answer.responses[1];
+                    if (result instanceof Error){
+                        reject(result);
+                        return;
                     }
-                    secondrequest().then(function (answer) {
-                        for (let i=0; i < result.keys.length; i++){
-                            if (prepare_sync === true){
-                                if (answer && answer.keys) {
-                                    for (let j=0;
-                                        j < answer.keys.length; j++ ){
-                                        const a = answer.keys[j];
-                                        const b = result.keys[i];
-                                        if (
-                                            a.fingerprint === b.fingerprint
-                                        ) {
-                                            if (a.secret === true){
-                                                b.hasSecret = true;
-                                            } else {
-                                                b.hasSecret = false;
-                                            }
-                                            break;
-                                        }
-                                    }
-                                }
+                    if (secret instanceof Error){
+                        reject(secret);
+                        return;
+                    }
+                }
+                let resultset = [];
+                for (let i=0; i < result.keys.length; i++){
+                    if (prepare_sync === true && secret.keys) {
+                        const b = result.keys[i];
+                        for (let j=0; j < secret.keys.length; j++ ){
+                            const a = secret.keys[j];
+                            if (a.fingerprint === b.fingerprint) {
+                                b.hasSecret = a.secret === true;
+                                break;
                             }
-                            let k = createKey(result.keys[i].fingerprint,
-                                !prepare_sync, result.keys[i]);
-                            resultset.push(k);
                         }
-                        resolve(resultset);
-                    }, function (error){
-                        reject(error);
-                    });
+                    }
+                    let k = createKey(result.keys[i].fingerprint,
+                        !prepare_sync, result.keys[i]);
+                    resultset.push(k);
                 }
+                resolve(resultset);
+            }, function (error){
+                reject(error);
             });
         });
     }
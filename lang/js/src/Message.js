@@ -58,12 +58,22 @@ export class GPGME_Message {
             chunksize: 1023* 1024
         };
         this._expected = null;
+        this._requests = null;
     }
 
     get operation (){
         return this._msg.op;
     }
 
+    /**
+     * The messages bundled by a 'batch' message, in the order of their
+     * answers.
+     * @returns {Array<GPGME_Message>|null}
+     */
+    get requests (){
+        return this._requests;
+    }
+
     set expected (value){
         if (value === 'uint8' || value === 'base64'){
             this._expected = value;
@@ -170,6 +180,14 @@ export class GPGME_Message {
                     if (val.length > 0) {
                         return true;
                     }
+                } else if (val instanceof GPGME_Message){
+                    if (poparam.allowed.indexOf('GPGME_Message') >= 0
+                        && permittedOperations[val.operation].batch === true
+                        && val.isComplete() === true
+                    ){
+                        return true;
+                    }
+                    throw gpgme_error('PARAM_WRONG');
                 } else if (val instanceof Uint8Array){
                     if (poparam.allowed.indexOf('Uint8Array') >= 0){
                         return true;
@@ -192,7 +210,15 @@ export class GPGME_Message {
                 return gpgme_error('PARAM_WRONG');
             }
         }
-        this._msg[param] = value;
+        if (poparam.allowed.indexOf('GPGME_Message') >= 0){
+            // Only the plain requests are sent to gpgme-json.
+            this._requests = Array.isArray(value) ? value : [value];
+            this._msg[param] = this._requests.map(function (msg){
+                return msg.message;
+            });
+        } else {
+            this._msg[param] = value;
+        }
         return true;
     }
 
@@ -39,6 +39,8 @@
  * @property {messageProperty} optional An object with all optional parameters
  * @property {Boolean} pinentry (optional) If true, a password dialog is
  *      expected, thus a connection tuimeout is not advisable
+ * @property {Boolean} batch (optional) If true, the operation may be bundled
+ *      with others into one 'batch' request
  * @property {Object} answer The definition on what to expect as answer, if the
  *      answer is not an error
  * @property {Array<String>} answer.type the type(s) as reported by gpgme-json.
@@ -191,6 +193,7 @@ export const permittedOperations = {
     // note: For the meaning of the optional keylist flags, refer to
     // https://www.gnupg.org/documentation/manuals/gpgme/Key-Listing-Mode.html
     keylist:{
+        batch: true,
         required: {},
 
         optional: {
@@ -240,6 +243,7 @@ export const permittedOperations = {
     },
 
     export: {
+        batch: true,
         required: {},
         optional: {
             'protocol': {
@@ -391,6 +395,25 @@ export const permittedOperations = {
         }
     },
 
+    // note: The requests are complete GPGME_Messages of operations
+    // flagged with 'batch'. The answers to them are demultiplexed by the
+    // Connection, see Answer._processResponse
+    batch: {
+        required: {
+            'requests': {
+                allowed: ['GPGME_Message'],
+                array_allowed: true
+            }
+        },
+        optional: {},
+        answer: {
+            type: ['batch'],
+            info: {
+                'responses': 'object'
+            }
+        }
+    },
+
     config_opt: {
         required: {
             'component':{
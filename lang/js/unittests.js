@@ -379,6 +379,37 @@ function unittests (){
                 }).to.throw(err_list.PARAM_WRONG.msg);
             }
         });
+
+        it('Batch Message contains the bundled requests', function (){
+            let test0 = createMessage('batch');
+            let keylist = createMessage('keylist');
+            keylist.setParameter('keys', hp.validFingerprint);
+            let exp = createMessage('export');
+            exp.setParameter('armor', true);
+            test0.setParameter('requests', [keylist, exp]);
+
+            expect(test0.isComplete()).to.be.true;
+            expect(test0.requests).to.deep.equal([keylist, exp]);
+            expect(test0.message.requests).to.have.lengthOf(2);
+            expect(test0.message.requests[0].op).to.equal('keylist');
+            expect(test0.message.requests[0].keys).to.equal(
+                hp.validFingerprint);
+            expect(test0.message.requests[1].op).to.equal('export');
+        });
+
+        it('Not accepting non-batchable requests', function (){
+            let test0 = createMessage('batch');
+            let enc = createMessage('encrypt');
+            enc.setParameter('data', mp.valid_encrypt_data);
+            enc.setParameter('keys', hp.validFingerprints);
+            expect(function (){
+                test0.setParameter('requests', [enc]);
+            }).to.throw(err_list.PARAM_WRONG.msg);
+            expect(function (){
+                test0.setParameter('requests', [{ op: 'keylist' }]);
+            }).to.throw(err_list.PARAM_WRONG.msg);
+            expect(test0.isComplete()).to.be.false;
+        });
     });
 
 }
@@ -45,6 +45,117 @@
 %feature("autodoc", "0");
 
 
+/* The module is built with -threads, which makes SWIG release the GIL
+   around every wrapped function.  Doing this for the many cheap
+   accessors only adds contention between Python threads.  Keep the
+   GIL by default and release it only around the functions which may
+   wait for an engine process or do file I/O.  The callbacks in
+   helpers.c reacquire the GIL with PyGILState_Ensure.  */
+%feature("nothreadallow");
+
+%define threadallow(func)
+%feature("nothreadallow", "0") func;
+%enddef
+
+threadallow(gpgme_ctx_pool_put)
+threadallow(gpgme_ctx_pool_release)
+threadallow(gpgme_ctx_set_engine_info)
+threadallow(gpgme_data_identify)
+threadallow(gpgme_data_new_from_file)
+threadallow(gpgme_data_new_from_filepart)
+threadallow(gpgme_data_read)
+threadallow(gpgme_data_seek)
+threadallow(gpgme_data_write)
+threadallow(gpgme_engine_check_version)
+threadallow(gpgme_get_dirinfo)
+threadallow(gpgme_get_engine_info)
+threadallow(gpgme_get_key)
+threadallow(gpgme_new)
+threadallow(gpgme_op_adduid)
+threadallow(gpgme_op_adduid_start)
+threadallow(gpgme_op_assuan_transact)
+threadallow(gpgme_op_assuan_transact_ext)
+threadallow(gpgme_op_assuan_transact_start)
+threadallow(gpgme_op_card_edit)
+threadallow(gpgme_op_card_edit_start)
+threadallow(gpgme_op_conf_dir)
+threadallow(gpgme_op_conf_load)
+threadallow(gpgme_op_conf_save)
+threadallow(gpgme_op_createkey)
+threadallow(gpgme_op_createkey_start)
+threadallow(gpgme_op_createsubkey)
+threadallow(gpgme_op_createsubkey_start)
+threadallow(gpgme_op_decrypt)
+threadallow(gpgme_op_decrypt_ext)
+threadallow(gpgme_op_decrypt_ext_start)
+threadallow(gpgme_op_decrypt_start)
+threadallow(gpgme_op_decrypt_verify)
+threadallow(gpgme_op_decrypt_verify_start)
+threadallow(gpgme_op_delete)
+threadallow(gpgme_op_delete_ext)
+threadallow(gpgme_op_delete_ext_start)
+threadallow(gpgme_op_delete_start)
+threadallow(gpgme_op_edit)
+threadallow(gpgme_op_edit_start)
+threadallow(gpgme_op_encrypt)
+threadallow(gpgme_op_encrypt_ext)
+threadallow(gpgme_op_encrypt_ext_start)
+threadallow(gpgme_op_encrypt_sign)
+threadallow(gpgme_op_encrypt_sign_ext)
+threadallow(gpgme_op_encrypt_sign_ext_start)
+threadallow(gpgme_op_encrypt_sign_start)
+threadallow(gpgme_op_encrypt_start)
+threadallow(gpgme_op_export)
+threadallow(gpgme_op_export_ext)
+threadallow(gpgme_op_export_ext_start)
+threadallow(gpgme_op_export_keys)
+threadallow(gpgme_op_export_keys_start)
+threadallow(gpgme_op_export_start)
+threadallow(gpgme_op_genkey)
+threadallow(gpgme_op_genkey_start)
+threadallow(gpgme_op_getauditlog)
+threadallow(gpgme_op_getauditlog_start)
+threadallow(gpgme_op_import)
+threadallow(gpgme_op_import_ext)
+threadallow(gpgme_op_import_keys)
+threadallow(gpgme_op_import_keys_start)
+threadallow(gpgme_op_import_start)
+threadallow(gpgme_op_interact)
+threadallow(gpgme_op_interact_start)
+threadallow(gpgme_op_keylist_end)
+threadallow(gpgme_op_keylist_ext_start)
+threadallow(gpgme_op_keylist_from_data_start)
+threadallow(gpgme_op_keylist_next)
+threadallow(gpgme_op_keylist_start)
+threadallow(gpgme_op_keysign)
+threadallow(gpgme_op_keysign_start)
+threadallow(gpgme_op_passwd)
+threadallow(gpgme_op_passwd_start)
+threadallow(gpgme_op_query_swdb)
+threadallow(gpgme_op_revuid)
+threadallow(gpgme_op_revuid_start)
+threadallow(gpgme_op_set_uid_flag)
+threadallow(gpgme_op_set_uid_flag_start)
+threadallow(gpgme_op_sign)
+threadallow(gpgme_op_sign_start)
+threadallow(gpgme_op_spawn)
+threadallow(gpgme_op_spawn_start)
+threadallow(gpgme_op_tofu_policy)
+threadallow(gpgme_op_tofu_policy_start)
+threadallow(gpgme_op_trustlist_end)
+threadallow(gpgme_op_trustlist_next)
+threadallow(gpgme_op_trustlist_start)
+threadallow(gpgme_op_verify)
+threadallow(gpgme_op_verify_start)
+threadallow(gpgme_op_vfs_create)
+threadallow(gpgme_op_vfs_mount)
+threadallow(gpgme_release)
+threadallow(gpgme_set_engine_info)
+threadallow(gpgme_set_protocol)
+threadallow(gpgme_wait)
+threadallow(gpgme_wait_ext)
+
+
 /* Allow use of Unicode objects, bytes, and None for strings.  */
 %typemap(in) const char *(PyObject *encodedInput = NULL) {
   if ($input == Py_None)
@@ -656,6 +767,15 @@ _gpg_wrap_gpgme_data_t(gpgme_data_t data)
   return SWIG_NewPointerObj(data, SWIGTYPE_p_gpgme_data, 0);
 }
 
+PyObject *
+_gpg_wrap_gpgme_key_t(gpgme_key_t key)
+{
+  /* See _gpg_wrap_gpgme_data_t.  */
+  PyObject* self = NULL;
+  (void) self;
+  return SWIG_NewPointerObj(key, SWIGTYPE_p__gpgme_key, 0);
+}
+
 gpgme_ctx_t
 _gpg_unwrap_gpgme_ctx_t(PyObject *wrapped)
 {
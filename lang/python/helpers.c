@@ -23,6 +23,7 @@
 #endif
 
 #include <assert.h>
+#include <errno.h>
 #include <stdio.h>
 #include <gpgme.h>
 #include <stdlib.h>
@@ -783,6 +784,237 @@ _gpg_interact_cb(void *opaque, const char *keyword,
 
 
 
+/* I/O callbacks.  */
+
+/* An I/O callback registered by GPGME.  It is handed to Python in a
+   capsule, which owns it.  */
+struct io_cb_data
+{
+  gpgme_io_cb_t fnc;
+  void *fnc_data;
+  int fd;
+  PyObject *hook;
+  PyObject *pytag;
+};
+
+#define IO_CB_CAPSULE "gpg.io_cb"
+
+static void ioCbCapsuleDestructor(PyObject *capsule)
+{
+  free(PyCapsule_GetPointer(capsule, IO_CB_CAPSULE));
+}
+
+/* Register FNC for FD with the add function of the Python event loop
+   in HOOK.  The tag is the capsule for FNC.  */
+static gpgme_error_t pyIOAddCb(void *hook, int fd, int dir,
+                               gpgme_io_cb_t fnc, void *fnc_data,
+                               void **r_tag)
+{
+  PyGILState_STATE state = PyGILState_Ensure();
+  gpgme_error_t err = 0;
+  PyObject *pyhook = (PyObject *) hook;
+  PyObject *self = NULL;
+  PyObject *func = NULL;
+  PyObject *capsule = NULL;
+  struct io_cb_data *io;
+
+  assert (PyTuple_Check(pyhook));
+  assert (PyTuple_Size(pyhook) == 4);
+  self = PyTuple_GetItem(pyhook, 0);
+  func = PyTuple_GetItem(pyhook, 1);
+
+  io = calloc(1, sizeof *io);
+  if (io == NULL)
+    {
+      err = gpg_error_from_syserror();
+      goto leave;
+    }
+  io->fnc = fnc;
+  io->fnc_data = fnc_data;
+  io->fd = fd;
+  io->hook = pyhook;
+
+  capsule = PyCapsule_New(io, IO_CB_CAPSULE, ioCbCapsuleDestructor);
+  if (capsule == NULL)
+    {
+      free(io);
+      err = _gpg_exception2code();
+      goto leave;
+    }
+
+  io->pytag = PyObject_CallFunction(func, "iiO", fd, dir, capsule);
+  if (io->pytag == NULL)
+    {
+      err = _gpg_exception2code();
+      Py_DECREF(capsule);
+      goto leave;
+    }
+
+  /* We keep the reference to the capsule until it is removed.  */
+  *r_tag = capsule;
+
+ leave:
+  if (err)
+    _gpg_stash_callback_exception(self);
+  PyGILState_Release(state);
+  return err;
+}
+
+static void pyIORemoveCb(void *tag)
+{
+  PyGILState_STATE state = PyGILState_Ensure();
+  PyObject *capsule = (PyObject *) tag;
+  struct io_cb_data *io;
+  PyObject *self = NULL;
+  PyObject *func = NULL;
+  PyObject *retval = NULL;
+
+  io = PyCapsule_GetPointer(capsule, IO_CB_CAPSULE);
+  assert (io);
+  self = PyTuple_GetItem(io->hook, 0);
+  func = PyTuple_GetItem(io->hook, 2);
+
+  /* The capsule may still be referenced by the event loop.  */
+  io->fnc = NULL;
+
+  retval = PyObject_CallFunctionObjArgs(func, io->pytag, NULL);
+  Py_XDECREF(retval);
+  if (PyErr_Occurred())
+    _gpg_stash_callback_exception(self);
+  Py_CLEAR(io->pytag);
+  Py_DECREF(capsule);
+  PyGILState_Release(state);
+}
+
+static void pyIOEventCb(void *hook, gpgme_event_io_t type, void *type_data)
+{
+  PyGILState_STATE state = PyGILState_Ensure();
+  PyObject *pyhook = (PyObject *) hook;
+  PyObject *self = NULL;
+  PyObject *func = NULL;
+  PyObject *data = NULL;
+  PyObject *retval = NULL;
+
+  assert (PyTuple_Check(pyhook));
+  assert (PyTuple_Size(pyhook) == 4);
+  self = PyTuple_GetItem(pyhook, 0);
+  func = PyTuple_GetItem(pyhook, 3);
+
+  switch (type)
+    {
+    case GPGME_EVENT_DONE:
+      {
+        struct gpgme_io_event_done_data *done = type_data;
+        data = Py_BuildValue("(II)", done->err, done->op_err);
+      }
+      break;
+
+    case GPGME_EVENT_NEXT_KEY:
+      /* We own one reference to the key, which is passed on to the
+         Python object.  */
+      data = _gpg_wrap_gpgme_key_t(type_data);
+      if (data == NULL)
+        gpgme_key_unref(type_data);
+      break;
+
+    case GPGME_EVENT_NEXT_TRUSTITEM:
+      gpgme_trust_item_unref(type_data);
+      /* Fall through.  */
+    default:
+      Py_INCREF(Py_None);
+      data = Py_None;
+      break;
+    }
+
+  if (data)
+    {
+      retval = PyObject_CallFunction(func, "iO", (int) type, data);
+      Py_DECREF(data);
+      Py_XDECREF(retval);
+    }
+  if (PyErr_Occurred())
+    _gpg_stash_callback_exception(self);
+  PyGILState_Release(state);
+}
+
+PyObject *
+gpg_set_io_cbs(PyObject *self, PyObject *cbs)
+{
+  PyGILState_STATE state = PyGILState_Ensure();
+  PyObject *wrapped;
+  gpgme_ctx_t ctx;
+  struct gpgme_io_cbs io_cbs;
+
+  wrapped = PyObject_GetAttrString(self, "wrapped");
+  if (wrapped == NULL)
+    {
+      assert (PyErr_Occurred ());
+      PyGILState_Release(state);
+      return NULL;
+    }
+
+  ctx = _gpg_unwrap_gpgme_ctx_t(wrapped);
+  Py_DECREF(wrapped);
+  if (ctx == NULL)
+    {
+      if (cbs == Py_None)
+        goto out;
+      else
+        return PyErr_Format(PyExc_RuntimeError, "wrapped is NULL");
+    }
+
+  if (cbs == Py_None) {
+    gpgme_set_io_cbs(ctx, NULL);
+    PyObject_SetAttrString(self, "_io_cbs", Py_None);
+    goto out;
+  }
+
+  if (! PyTuple_Check(cbs))
+    return PyErr_Format(PyExc_TypeError, "cbs must be a tuple");
+  if (PyTuple_Size(cbs) != 4)
+    return PyErr_Format(PyExc_TypeError,
+                        "cbs must be a tuple of size 4");
+
+  io_cbs.add = pyIOAddCb;
+  io_cbs.add_priv = cbs;
+  io_cbs.remove = pyIORemoveCb;
+  io_cbs.event = pyIOEventCb;
+  io_cbs.event_priv = cbs;
+  gpgme_set_io_cbs(ctx, &io_cbs);
+  PyObject_SetAttrString(self, "_io_cbs", cbs);
+
+ out:
+  Py_INCREF(Py_None);
+  PyGILState_Release(state);
+  return Py_None;
+}
+
+/* Run the I/O callback in CAPSULE, which was passed to the add
+   function of the event loop, and return its error code.  */
+PyObject *
+gpg_io_cb_run(PyObject *capsule)
+{
+  struct io_cb_data *io;
+  gpgme_error_t err = 0;
+
+  io = PyCapsule_GetPointer(capsule, IO_CB_CAPSULE);
+  if (io == NULL)
+    return NULL;
+
+  /* Do nothing if the callback has already been removed.  */
+  if (io->fnc)
+    {
+      gpgme_io_cb_t fnc = io->fnc;
+
+      Py_BEGIN_ALLOW_THREADS;
+      err = fnc(io->fnc_data, io->fd);
+      Py_END_ALLOW_THREADS;
+    }
+  return PyLong_FromUnsignedLong(err);
+}
+
+
+
 /* Data callbacks.  */
 
 /* Read up to SIZE bytes into buffer BUFFER from the data object with
@@ -1053,6 +1285,163 @@ gpg_data_new_from_cbs(PyObject *self,
 
 
 
+/* Data objects backed by a Python buffer.  */
+
+struct buffer_data
+{
+  Py_buffer view;
+  size_t pos;
+};
+
+/* Read up to SIZE bytes from the buffer of HOOK into BUFFER.  The
+   buffer callbacks do not touch Python objects and thus may run
+   without the GIL; the memory is pinned by the view.  */
+static ssize_t bufferDataReadCb(void *hook, void *buffer, size_t size)
+{
+  struct buffer_data *bd = hook;
+  size_t len = (size_t) bd->view.len;
+
+  if (bd->pos >= len)
+    return 0;
+  if (size > len - bd->pos)
+    size = len - bd->pos;
+  memcpy(buffer, (char *) bd->view.buf + bd->pos, size);
+  bd->pos += size;
+  return size;
+}
+
+/* Write up to SIZE bytes from BUFFER into the buffer of HOOK.  The
+   buffer can not grow; writing past its end fails with ENOSPC.  */
+static ssize_t bufferDataWriteCb(void *hook, const void *buffer, size_t size)
+{
+  struct buffer_data *bd = hook;
+  size_t len = (size_t) bd->view.len;
+
+  if (bd->view.readonly)
+    {
+      errno = EBADF;
+      return -1;
+    }
+  if (size && bd->pos >= len)
+    {
+      errno = ENOSPC;
+      return -1;
+    }
+  if (size > len - bd->pos)
+    size = len - bd->pos;
+  memcpy((char *) bd->view.buf + bd->pos, buffer, size);
+  bd->pos += size;
+  return size;
+}
+
+static off_t bufferDataSeekCb(void *hook, off_t offset, int whence)
+{
+  struct buffer_data *bd = hook;
+  off_t base;
+
+  switch (whence)
+    {
+    case SEEK_SET:
+      base = 0;
+      break;
+    case SEEK_CUR:
+      base = (off_t) bd->pos;
+      break;
+    case SEEK_END:
+      base = (off_t) bd->view.len;
+      break;
+    default:
+      errno = EINVAL;
+      return -1;
+    }
+
+  if (offset < -base || base + offset > (off_t) bd->view.len)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+  bd->pos = (size_t) (base + offset);
+  return (off_t) bd->pos;
+}
+
+static void bufferDataReleaseCb(void *hook)
+{
+  PyGILState_STATE state = PyGILState_Ensure();
+  struct buffer_data *bd = hook;
+
+  PyBuffer_Release(&bd->view);
+  free(bd);
+  PyGILState_Release(state);
+}
+
+/* Create a data object which reads from and writes into the memory
+   of the object BUFFER, which must implement the buffer protocol.
+   Nothing is copied.  The object is kept alive and can not be
+   resized until the data object is released.  If BUFFER is read-only
+   the data object can only be read from.  */
+PyObject *
+gpg_data_new_from_buffer(PyObject *self, PyObject *buffer,
+                         gpgme_data_t *r_data)
+{
+  static struct gpgme_data_cbs cbs = {
+    bufferDataReadCb,
+    bufferDataWriteCb,
+    bufferDataSeekCb,
+    bufferDataReleaseCb,
+  };
+  struct buffer_data *bd;
+  gpgme_error_t err;
+
+  (void) self;
+  bd = calloc(1, sizeof *bd);
+  if (bd == NULL)
+    return PyErr_NoMemory();
+
+  if (PyObject_GetBuffer(buffer, &bd->view, PyBUF_WRITABLE) < 0)
+    {
+      PyErr_Clear();
+      if (PyObject_GetBuffer(buffer, &bd->view, PyBUF_SIMPLE) < 0)
+        {
+          free(bd);
+          return NULL;
+        }
+    }
+
+  err = gpgme_data_new_from_cbs(r_data, &cbs, bd);
+  if (err)
+    {
+      PyBuffer_Release(&bd->view);
+      free(bd);
+      return _gpg_raise_exception(err);
+    }
+
+  Py_INCREF(Py_None);
+  return Py_None;
+}
+
+/* Read from DH into the writable object BUFFER, which must implement
+   the buffer protocol, and return the number of bytes read.  */
+PyObject *
+gpg_data_readinto(gpgme_data_t dh, PyObject *buffer)
+{
+  Py_buffer view;
+  ssize_t result;
+
+  if (PyObject_GetBuffer(buffer, &view, PyBUF_WRITABLE) < 0)
+    return NULL;
+
+  Py_BEGIN_ALLOW_THREADS;
+  result = gpgme_data_read(dh, view.buf, (size_t) view.len);
+  Py_END_ALLOW_THREADS;
+
+  PyBuffer_Release(&view);
+  if (result < 0)
+    return PyErr_SetFromErrno(PyExc_RuntimeError);
+  return PyLong_FromSsize_t(result);
+}
+
+
+
 /* The assuan callbacks.  */
 
 gpgme_error_t
@@ -38,6 +38,11 @@ PyObject *gpg_raise_callback_exception(PyObject *self);
 PyObject *gpg_set_passphrase_cb(PyObject *self, PyObject *cb);
 PyObject *gpg_set_progress_cb(PyObject *self, PyObject *cb);
 PyObject *gpg_set_status_cb(PyObject *self, PyObject *cb);
+PyObject *gpg_set_io_cbs(PyObject *self, PyObject *cbs);
+PyObject *gpg_io_cb_run(PyObject *capsule);
 
 PyObject *gpg_data_new_from_cbs(PyObject *self, PyObject *pycbs,
 				 gpgme_data_t *r_data);
+PyObject *gpg_data_new_from_buffer(PyObject *self, PyObject *buffer,
+				    gpgme_data_t *r_data);
+PyObject *gpg_data_readinto(gpgme_data_t dh, PyObject *buffer);
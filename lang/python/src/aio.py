@@ -0,0 +1,211 @@
+# -*- coding: utf-8 -*-
+
+# Copyright (C) 2026 g10 Code GmbH
+#
+#    This library is free software; you can redistribute it and/or
+#    modify it under the terms of the GNU Lesser General Public
+#    License as published by the Free Software Foundation; either
+#    version 2.1 of the License, or (at your option) any later version.
+#
+#    This library is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+#    Lesser General Public License for more details.
+#
+#    You should have received a copy of the GNU Lesser General Public
+#    License along with this library; if not, see <https://www.gnu.org/licenses/>.
+"""asyncio support
+
+Runs GPGME operations on an asyncio event loop.  The file descriptors
+of the engines are watched by the loop, so that many operations can
+run concurrently in a single thread:
+
+    >>> import asyncio
+    >>> import gpg.aio
+    >>> async def main():
+    ...     with gpg.aio.AsyncContext(armor=True) as c:
+    ...         cipher, _, _ = await c.encrypt(b"Hello world :)",
+    ...                                        passphrase="abc")
+    ...         async for key in c.keylist():
+    ...             print(key.fpr)
+    >>> asyncio.run(main())
+
+This module requires Python 3.6 or later.
+
+"""
+
+import asyncio
+import collections
+import functools
+import weakref
+
+from . import constants
+from . import core
+from . import errors
+from . import gpgme
+
+
+def _awaitable(method):
+    """Return a coroutine function running the idiomatic METHOD of
+    Context on the event loop."""
+    body = method.body
+
+    @functools.wraps(method)
+    async def wrapper(self, *args, **kwargs):
+        return await self._run_async(body(self, *args, **kwargs))
+
+    return wrapper
+
+
+def _io_cbs(loop, ctx):
+    """Return the I/O callbacks for CTX running on LOOP."""
+
+    def add(fd, dir, run):
+        if dir:
+            loop.add_reader(fd, run)
+        else:
+            loop.add_writer(fd, run)
+        return fd, dir
+
+    def remove(tag):
+        fd, dir = tag
+        if dir:
+            loop.remove_reader(fd)
+        else:
+            loop.remove_writer(fd)
+
+    # Do not keep the context alive.
+    ref = weakref.ref(ctx)
+
+    def event(type, data):
+        ctx = ref()
+        if ctx is not None:
+            ctx._io_event(type, data)
+
+    return add, remove, event
+
+
+class AsyncContext(core.Context):
+    """Context running its operations on an asyncio event loop
+
+    The idiomatic methods encrypt, decrypt, sign, and verify are
+    coroutines, and keylist is an asynchronous iterator.  Otherwise,
+    this is a Context.  Like a Context, an AsyncContext runs one
+    operation at a time; use one context per concurrent operation.
+
+    """
+
+    def __init__(self, loop=None, **kwargs):
+        """Construct a context object
+
+        Keyword arguments:
+        loop		-- the event loop (default: the current event loop)
+
+        All other keyword arguments are passed to Context.
+
+        """
+        super(AsyncContext, self).__init__(**kwargs)
+        self._loop = loop or asyncio.get_event_loop()
+        self._done = None
+        self._keys = None
+        self._wakeup = None
+        self.set_io_cbs(*_io_cbs(self._loop, self))
+
+    def _io_event(self, type, data):
+        if type == constants.event.NEXT_KEY:
+            data.__del__ = lambda self: gpgme.gpgme_key_unref(self)
+            if self._keys is not None:
+                self._keys.append(data)
+        elif type == constants.event.DONE:
+            done, self._done = self._done, None
+            if done is not None and not done.done():
+                err = data[0] or data[1]
+                if err:
+                    done.set_exception(errors.GPGMEError(err))
+                else:
+                    done.set_result(None)
+        if self._wakeup is not None and not self._wakeup.done():
+            self._wakeup.set_result(None)
+
+    def _start(self, name, *args):
+        """Start the operation NAME and return a future for its end."""
+        assert self._done is None, "an operation is already running"
+        done = self._loop.create_future()
+        self._done = done
+        try:
+            getattr(self, name + '_start')(*args)
+        except BaseException:
+            self._done = None
+            raise
+        return done
+
+    async def _operation(self, name, *args):
+        """Run the operation NAME on the event loop."""
+        done = self._start(name, *args)
+        try:
+            await done
+        except asyncio.CancelledError:
+            gpgme.gpgme_cancel(self.wrapped)
+            raise
+        except errors.GPGMEError:
+            if self._callback_excinfo:
+                gpgme.gpg_raise_callback_exception(self)
+            raise
+        if self._callback_excinfo:
+            gpgme.gpg_raise_callback_exception(self)
+
+    async def _run_async(self, body):
+        """Drive the generator BODY of an idiomatic method, see
+        core._operation_body, running each operation on the loop."""
+        name, args = next(body)
+        while name is not None:
+            try:
+                await self._operation(name, *args)
+            except BaseException as e:
+                name, args = body.throw(e)
+            else:
+                name, args = body.send(None)
+        body.close()
+        return args
+
+    encrypt = _awaitable(core.Context.encrypt)
+    decrypt = _awaitable(core.Context.decrypt)
+    sign = _awaitable(core.Context.sign)
+    verify = _awaitable(core.Context.verify)
+
+    async def keylist(self,
+                      pattern=None,
+                      secret=False,
+                      mode=constants.keylist.mode.LOCAL,
+                      source=None):
+        """List keys
+
+        Like Context.keylist, but returns an asynchronous iterator.
+
+        """
+        if not source:
+            self.set_keylist_mode(mode)
+            name, args = 'op_keylist', (pattern, secret)
+        else:
+            if not isinstance(source, core.Data):
+                source = core.Data(file=source)
+            name, args = 'op_keylist_from_data', (source, 0)
+
+        keys = self._keys = collections.deque()
+        done = self._start(name, *args)
+        try:
+            while keys or not done.done():
+                if not keys:
+                    self._wakeup = self._loop.create_future()
+                    await self._wakeup
+                while keys:
+                    yield keys.popleft()
+            # Raise the error of the operation, if any.
+            await done
+        finally:
+            self._keys = self._wakeup = None
+            if not done.done():
+                gpgme.gpgme_cancel(self.wrapped)
+        if self._callback_excinfo:
+            gpgme.gpg_raise_callback_exception(self)
+        self.op_keylist_end()
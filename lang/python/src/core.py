@@ -2,6 +2,7 @@
 
 from __future__ import absolute_import, print_function, unicode_literals
 
+import functools
 import re
 import os
 import warnings
@@ -41,6 +42,28 @@ and the 'Data' class describing buffers of data.
 """
 
 
+def _operation_body(body):
+    """Idiomatic method decorator
+
+    BODY is a generator which yields (NAME, ARGS) to run the low-level
+    operation NAME, e.g. 'op_encrypt', with ARGS.  The outcome of the
+    operation is sent back into the generator, or raised at the yield
+    in case of an error.  Finally, it yields (None, RESULT).
+
+    The decorated method runs the operations blocking.  The generator
+    function is available as attribute 'body' so that the operations
+    can be driven differently, see gpg.aio.
+
+    """
+
+    @functools.wraps(body)
+    def method(self, *args, **kwargs):
+        return self._run_blocking(body(self, *args, **kwargs))
+
+    method.body = body
+    return method
+
+
 class GpgmeWrapper(object):
     """Base wrapper class
 
@@ -220,6 +243,20 @@ class Context(GpgmeWrapper):
         self.protocol = protocol
         self.home_dir = home_dir
 
+    def _run_blocking(self, body):
+        """Drive the generator BODY of an idiomatic method, see
+        _operation_body, running each operation blocking."""
+        name, args = next(body)
+        while name is not None:
+            try:
+                getattr(self, name)(*args)
+            except BaseException as e:
+                name, args = body.throw(e)
+            else:
+                name, args = body.send(None)
+        body.close()
+        return args
+
     def __read__(self, sink, data):
         """Read helper
 
@@ -238,6 +275,7 @@ class Context(GpgmeWrapper):
                 "protocol={0.protocol}, home_dir={0.home_dir}"
                 ")").format(self)
 
+    @_operation_body
     def encrypt(self,
                 plaintext,
                 recipients=[],
@@ -300,9 +338,10 @@ class Context(GpgmeWrapper):
 
         try:
             if sign:
-                self.op_encrypt_sign(recipients, flags, plaintext, ciphertext)
+                yield 'op_encrypt_sign', (recipients, flags, plaintext,
+                                          ciphertext)
             else:
-                self.op_encrypt(recipients, flags, plaintext, ciphertext)
+                yield 'op_encrypt', (recipients, flags, plaintext, ciphertext)
         except errors.GPGMEError as e:
             result = self.op_encrypt_result()
             sig_result = self.op_sign_result() if sign else None
@@ -335,8 +374,9 @@ class Context(GpgmeWrapper):
         sig_result = self.op_sign_result() if sign else None
         assert not sig_result or not sig_result.invalid_signers
 
-        return self.__read__(sink, ciphertext), result, sig_result
+        yield None, (self.__read__(sink, ciphertext), result, sig_result)
 
+    @_operation_body
     def decrypt(self, ciphertext, sink=None, passphrase=None, verify=True):
         """Decrypt data
 
@@ -398,9 +438,9 @@ class Context(GpgmeWrapper):
                 do_sig_verification = True
 
             if do_sig_verification:
-                self.op_decrypt_verify(ciphertext, plaintext)
+                yield 'op_decrypt_verify', (ciphertext, plaintext)
             else:
-                self.op_decrypt(ciphertext, plaintext)
+                yield 'op_decrypt', (ciphertext, plaintext)
         except errors.GPGMEError as e:
             result = self.op_decrypt_result()
             if do_sig_verification:
@@ -456,8 +496,9 @@ class Context(GpgmeWrapper):
                     raise errors.MissingSignatures(verify_result, missing,
                                                    results=results)
 
-        return results
+        yield None, results
 
+    @_operation_body
     def sign(self, data, sink=None, mode=constants.SIG_MODE_NORMAL):
         """Sign data
 
@@ -484,7 +525,7 @@ class Context(GpgmeWrapper):
         signeddata = sink if sink else Data()
 
         try:
-            self.op_sign(data, signeddata, mode)
+            yield 'op_sign', (data, signeddata, mode)
         except errors.GPGMEError as e:
             results = (self.__read__(sink, signeddata), self.op_sign_result())
             if e.getcode() == errors.UNUSABLE_SECKEY:
@@ -499,8 +540,9 @@ class Context(GpgmeWrapper):
         result = self.op_sign_result()
         assert not result.invalid_signers
 
-        return self.__read__(sink, signeddata), result
+        yield None, (self.__read__(sink, signeddata), result)
 
+    @_operation_body
     def verify(self, signed_data, signature=None, sink=None, verify=[]):
         """Verify signatures
 
@@ -531,9 +573,9 @@ class Context(GpgmeWrapper):
 
         try:
             if signature:
-                self.op_verify(signature, signed_data, None)
+                yield 'op_verify', (signature, signed_data, None)
             else:
-                self.op_verify(signed_data, None, data)
+                yield 'op_verify', (signed_data, None, data)
         except errors.GPGMEError as e:
             # Just raise the error, but attach the results first.
             e.results = (self.__read__(sink, data), self.op_verify_result())
@@ -561,7 +603,7 @@ class Context(GpgmeWrapper):
             raise errors.MissingSignatures(
                 results[1], missing, results=results)
 
-        return results
+        yield None, results
 
     def key_import(self, data):
         """Import data
@@ -1329,6 +1371,36 @@ class Context(GpgmeWrapper):
         if gpgme.gpg_set_status_cb:
             self.set_status_cb(None)
 
+    def set_io_cbs(self, add, remove, event):
+        """Sets the I/O callbacks to run operations on an external event loop.
+
+        ADD is called as add(fd, dir, run) whenever GPGME needs to
+        watch the file descriptor FD, for reading if DIR is 1 and for
+        writing if DIR is 0.  The event loop must call run() whenever
+        FD is ready.  The return value of ADD is passed to REMOVE once
+        FD is no longer watched.
+
+        EVENT is called as event(type, data).  For constants.event.DONE,
+        data is the tuple (err, op_err) with the result of the operation.
+        For constants.event.NEXT_KEY, data is the next key of a key listing,
+        which is not available from op_keylist_next in this case.
+
+        If ADD is None, GPGME's own event loop is used again.  The
+        callbacks must not be changed while an operation is running.
+
+        Please see the GPGME manual for more information.
+
+        """
+        if add is None:
+            hookdata = None
+        else:
+
+            def add_io(fd, dir, cb):
+                return add(fd, dir, lambda: gpgme.gpg_io_cb_run(cb))
+
+            hookdata = (weakref.ref(self), add_io, remove, event)
+        gpgme.gpg_set_io_cbs(self, hookdata)
+
     @property
     def engine_info(self):
         """Configuration of the engine currently in use"""
@@ -1437,7 +1509,8 @@ class Data(GpgmeWrapper):
                  offset=None,
                  length=None,
                  cbs=None,
-                 copy=True):
+                 copy=True,
+                 buffer=None):
         """Initialize a new gpgme_data_t object.
 
         If no args are specified, make it an empty object.
@@ -1477,12 +1550,19 @@ class Data(GpgmeWrapper):
         it must be a filename, and the object will be initialized from
         that file.
 
+        If buffer is specified, it must be an object implementing the
+        buffer protocol, like bytearray, memoryview, or mmap.  The
+        object reads from and writes into the memory of buffer without
+        copying, see new_from_buffer.
+
         """
         super(Data, self).__init__(None)
         self.data_cbs = None
 
         if cbs is not None:
             self.new_from_cbs(*cbs)
+        elif buffer is not None:
+            self.new_from_buffer(buffer)
         elif string is not None:
             self.new_from_mem(string, copy)
         elif file is not None and offset is not None and length is not None:
@@ -1554,6 +1634,23 @@ class Data(GpgmeWrapper):
         self.wrapped = gpgme.gpgme_data_t_p_value(tmp)
         gpgme.delete_gpgme_data_t_p(tmp)
 
+    def new_from_buffer(self, buffer):
+        """Use the memory of buffer, which must implement the buffer
+        protocol, for this object.  Nothing is copied.
+
+        Reading starts at the beginning of buffer and ends at its end.
+        Writing overwrites buffer from the current position on and
+        fails once the end is reached; after an operation, use
+        seek(0, os.SEEK_CUR) to get the number of bytes written.
+        Read-only buffers, e.g. bytes, can only be read.  buffer can
+        not be resized while it is used by this object.
+
+        """
+        tmp = gpgme.new_gpgme_data_t_p()
+        gpgme.gpg_data_new_from_buffer(self, buffer, tmp)
+        self.wrapped = gpgme.gpgme_data_t_p_value(tmp)
+        gpgme.delete_gpgme_data_t_p(tmp)
+
     def new_from_filepart(self, file, offset, length):
         """This wraps the GPGME gpgme_data_new_from_filepart() function.
         The argument "file" may be:
@@ -1637,19 +1734,33 @@ class Data(GpgmeWrapper):
                     raise
             return result
         else:
-            chunks = []
+            # Read into a single growing buffer.
+            result = bytearray(65536)
+            length = 0
             while True:
-                try:
-                    result = gpgme.gpgme_data_read(self.wrapped, 4096)
-                except:
-                    if self._callback_excinfo:
-                        gpgme.gpg_raise_callback_exception(self)
-                    else:
-                        raise
-                if len(result) == 0:
+                if length == len(result):
+                    result.extend(bytearray(len(result)))
+                n = self.readinto(memoryview(result)[length:])
+                if n == 0:
                     break
-                chunks.append(result)
-            return b''.join(chunks)
+                length += n
+            del result[length:]
+            return bytes(result)
+
+    def readinto(self, buffer):
+        """Read into buffer, which must be a writable object
+        implementing the buffer protocol, like bytearray, memoryview,
+        or mmap.
+
+        Returns the number of bytes read, which is 0 at EOF."""
+        try:
+            result = gpgme.gpg_data_readinto(self.wrapped, buffer)
+        except:
+            if self._callback_excinfo:
+                gpgme.gpg_raise_callback_exception(self)
+            else:
+                raise
+        return result
 
 
 def pubkey_algo_string(subkey):
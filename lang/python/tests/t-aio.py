@@ -0,0 +1,105 @@
+#!/usr/bin/env python
+
+# Copyright (C) 2026 g10 Code GmbH
+#
+# This file is part of GPGME.
+#
+# GPGME is free software; you can redistribute it and/or modify it
+# under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2 of the License, or
+# (at your option) any later version.
+#
+# GPGME is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+# or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General
+# Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program; if not, see <https://www.gnu.org/licenses/>.
+
+from __future__ import absolute_import, print_function, unicode_literals
+
+import sys
+import gpg
+import support
+
+del absolute_import, print_function, unicode_literals
+
+# gpg.aio needs Python 3.6.  This file is kept free of the async
+# syntax so that it can be parsed by older versions.
+if sys.version_info < (3, 6):
+    sys.exit(77)
+
+import asyncio
+import gpg.aio
+
+loop = asyncio.new_event_loop()
+asyncio.set_event_loop(loop)
+
+# Run several operations concurrently on a single thread.
+n = 8
+plaintexts = ["Hallo Leute {}\n".format(i).encode() for i in range(n)]
+contexts = [gpg.aio.AsyncContext(loop=loop) for i in range(n)]
+keys = [contexts[0].get_key(support.alpha, False)]
+
+results = loop.run_until_complete(
+    asyncio.gather(*[
+        c.encrypt(p, recipients=keys, sign=False, always_trust=True)
+        for c, p in zip(contexts, plaintexts)
+    ]))
+ciphertexts = [r[0] for r in results]
+assert all(ciphertexts)
+
+results = loop.run_until_complete(
+    asyncio.gather(*[
+        c.decrypt(t, verify=False) for c, t in zip(contexts, ciphertexts)
+    ]))
+assert [r[0] for r in results] == plaintexts, results
+
+signed, _ = loop.run_until_complete(
+    contexts[0].sign(b"Hallo Leute\n", mode=gpg.constants.sig.mode.NORMAL))
+data, result = loop.run_until_complete(contexts[1].verify(signed))
+assert data == b"Hallo Leute\n"
+assert len(result.signatures) == 1
+
+# Errors are raised by the coroutines.
+try:
+    loop.run_until_complete(contexts[0].decrypt(b"garbage", verify=False))
+except gpg.errors.GPGMEError:
+    pass
+else:
+    assert False, "expected an error"
+
+
+# Iterate over the keys while other operations are running.
+def keylist(c, pattern=None):
+    it = c.keylist(pattern)
+    fprs = []
+    while True:
+        try:
+            key = loop.run_until_complete(it.__anext__())
+        except StopAsyncIteration:
+            return fprs
+        fprs.append(key.fpr)
+
+
+fprs = keylist(contexts[0])
+with gpg.Context() as c:
+    assert fprs == [k.fpr for k in c.keylist()]
+assert support.alpha in fprs
+assert keylist(contexts[0], support.bob) == [support.bob]
+
+# The context is usable after an operation has been cancelled.
+task = loop.create_task(contexts[2].decrypt(ciphertexts[2], verify=False))
+loop.call_soon(task.cancel)
+try:
+    loop.run_until_complete(task)
+except asyncio.CancelledError:
+    pass
+plain, _, _ = loop.run_until_complete(
+    contexts[2].decrypt(ciphertexts[2], verify=False))
+assert plain == plaintexts[2]
+
+for c in contexts:
+    c.__exit__(None, None, None)
+loop.close()
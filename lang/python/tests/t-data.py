@@ -64,6 +64,43 @@ data.write(binjunk)
 data.seek(0, os.SEEK_SET)
 assert data.read() == binjunk
 
+# Test buffer objects.
+buf = bytearray(b'Hello world!')
+data = gpg.Data(buffer=buf)
+assert data.read() == b'Hello world!'
+data.seek(6, os.SEEK_SET)
+data.write(b'there')
+assert buf == bytearray(b'Hello there!')
+assert data.write(b'??') == 1
+assert buf == bytearray(b'Hello there?')
+try:
+    data.write(b'?')
+except Exception:
+    pass
+else:
+    assert False, "Expected an error, got none"
+del data
+buf.extend(b'!')   # No longer exported.
+
+data = gpg.Data(buffer=memoryview(binjunk))
+assert data.read() == binjunk
+
+# Test reading into a buffer.
+data = gpg.Data(binjunk)
+buf = bytearray(100)
+assert data.readinto(buf) == 100
+assert buf == bytearray(binjunk[:100])
+view = memoryview(buf)
+assert data.readinto(view[10:]) == 90
+assert buf[10:] == bytearray(binjunk[100:190])
+assert data.readinto(buf) == 66
+assert data.readinto(buf) == 0
+
+data = gpg.Data()
+data.write(binjunk * 1000)
+data.seek(0, os.SEEK_SET)
+assert data.read() == binjunk * 1000
+
 data = gpg.Data()
 data.set_file_name("foobar")
 assert data.get_file_name() == "foobar"
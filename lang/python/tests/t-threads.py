@@ -0,0 +1,75 @@
+#!/usr/bin/env python
+
+# Copyright (C) 2026 g10 Code GmbH
+#
+# This file is part of GPGME.
+#
+# GPGME is free software; you can redistribute it and/or modify it
+# under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2 of the License, or
+# (at your option) any later version.
+#
+# GPGME is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+# or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General
+# Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program; if not, see <https://www.gnu.org/licenses/>.
+
+from __future__ import absolute_import, print_function, unicode_literals
+
+import io
+import threading
+import gpg
+import support
+
+del absolute_import, print_function, unicode_literals
+
+# Run operations on several threads at once.  The GIL is released
+# while waiting for the engine and reacquired by the data and status
+# callbacks, which are called on the worker threads.
+
+nthreads = 4
+errors = []
+
+
+def worker(n):
+    try:
+        plaintext = "Hallo Leute {}\n".format(n).encode()
+        source = io.BytesIO(plaintext)
+        statuses = []
+
+        def read_cb(amount):
+            return source.read(amount)
+
+        def status_cb(keyword, args):
+            statuses.append(keyword)
+
+        with gpg.Context() as c:
+            c.set_status_cb(status_cb)
+            c.set_ctx_flag("full-status", "1")
+            sink = gpg.Data()
+            c.op_encrypt([c.get_key(support.alpha, False)],
+                         gpg.constants.ENCRYPT_ALWAYS_TRUST,
+                         gpg.Data(cbs=(read_cb, None, None, lambda: None)),
+                         sink)
+            sink.seek(0, io.SEEK_SET)
+            ciphertext = sink.read()
+            assert len(ciphertext) > 0
+            assert statuses
+
+            plain, _, _ = c.decrypt(ciphertext, verify=False)
+            assert plain == plaintext, plain
+    except Exception as e:
+        errors.append(e)
+
+
+threads = [threading.Thread(target=worker, args=(n, ))
+           for n in range(nthreads)]
+for t in threads:
+    t.start()
+for t in threads:
+    t.join()
+
+assert not errors, errors
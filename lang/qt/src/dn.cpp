@@ -38,7 +38,11 @@
 
 #include "dn.h"
 
-#include <gpg-error.h>
+#include <QCache>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <ctype.h>
 
 static const struct {
     const char *name;
@@ -64,11 +68,16 @@ static const unsigned int numOidMaps = sizeof oidmap / sizeof * oidmap;
 class QGpgME::DN::Private
 {
 public:
-    Private() : mRefCount(0) {}
+    Private()
+        : order{"CN", "L", "_X_", "OU", "O", "C"},
+          mRefCount(0)
+    {
+    }
     Private(const Private &other)
         : attributes(other.attributes),
-          reorderedAttributes(other.reorderedAttributes),
-          order{"CN", "L", "_X_", "OU", "O", "C"},
+          rawDN(other.rawDN),
+          prettyDN(other.prettyDN),
+          order(other.order),
           mRefCount(0)
     {
     }
@@ -94,20 +103,15 @@ public:
     }
 
     DN::Attribute::List attributes;
-    DN::Attribute::List reorderedAttributes;
+    // the string the attributes were parsed from, null if modified
+    QByteArray rawDN;
+    // prettyDN() for the current order, null if not yet computed
+    QString prettyDN;
     QStringList order;
 private:
     int mRefCount;
 };
 
-namespace
-{
-struct DnPair {
-    char *key;
-    char *value;
-};
-}
-
 // copied from CryptPlug and adapted to work on DN::Attribute::List:
 
 #define digitp(p)   (*(p) >= '0' && *(p) <= '9')
@@ -118,136 +122,93 @@ struct DnPair {
                      *(p) <= 'F'? (*(p)-'A'+10):(*(p)-'a'+10))
 #define xtoi_2(p)   ((xtoi_1(p) * 16) + xtoi_1((p)+1))
 
-static char *
-trim_trailing_spaces(char *string)
+/* Parse one attributeType=value pair of a DN into KEY and VALUE.
+   The value is unescaped while it is scanned, so that every character
+   is looked at once.  Returns the position after the value or NULL on
+   error.  This is not a validating parser and it does not support any
+   old-stylish syntax; gpgme is expected to return only rfc2253
+   compatible strings. */
+static const char *
+parse_dn_part(const char *string, QByteArray &key, QByteArray &value)
 {
-    char *p, *mark;
-
-    for (mark = NULL, p = string; *p; p++) {
-        if (isspace(*p)) {
-            if (!mark) {
-                mark = p;
-            }
-        } else {
-            mark = NULL;
-        }
-    }
-    if (mark) {
-        *mark = '\0';
-    }
-
-    return string;
-}
-
-/* Parse a DN and return an array-ized one.  This is not a validating
-   parser and it does not support any old-stylish syntax; gpgme is
-   expected to return only rfc2253 compatible strings. */
-static const unsigned char *
-parse_dn_part(DnPair *array, const unsigned char *string)
-{
-    const unsigned char *s, *s1;
-    size_t n;
-    char *p;
+    const char *s, *end;
 
     /* parse attributeType */
     for (s = string + 1; *s && *s != '='; s++)
         ;
     if (!*s) {
-        return NULL;    /* error */
+        return nullptr;    /* error */
     }
-    n = s - string;
-    if (!n) {
-        return NULL;    /* empty key */
-    }
-    p = (char *)malloc(n + 1);
-
-    memcpy(p, string, n);
-    p[n] = 0;
-    trim_trailing_spaces((char *)p);
+    for (end = s; end > string && isspace((unsigned char)end[-1]); end--)
+        ;
+    key.resize(0);
     // map OIDs to their names:
     for (unsigned int i = 0; i < numOidMaps; ++i)
-        if (!strcasecmp((char *)p, oidmap[i].oid)) {
-            free(p);
-            gpgrt_asprintf(&p, "%s", oidmap[i].name);
+        if (!qstrnicmp(string, oidmap[i].oid, end - string)
+                && !oidmap[i].oid[end - string]) {
+            key.append(oidmap[i].name);
             break;
         }
-    array->key = p;
-    string = s + 1;
+    if (key.isEmpty()) {
+        key.append(string, end - string);
+    }
+    s++;
 
-    if (*string == '#') {
+    value.resize(0);
+    if (*s == '#') {
         /* hexstring */
-        string++;
-        for (s = string; hexdigitp(s); s++) {
-            s++;
-        }
-        n = s - string;
-        if (!n || (n & 1)) {
-            return NULL;    /* empty or odd number of digits */
+        for (s++; hexdigitp(s) && hexdigitp(s + 1); s += 2) {
+            value.append(char(xtoi_2(s)));
         }
-        n /= 2;
-        array->value = p = (char *)malloc(n + 1);
-
-        for (s1 = string; n; s1 += 2, n--) {
-            *p++ = xtoi_2(s1);
-        }
-        *p = 0;
-    } else {
-        /* regular v3 quoted string */
-        for (n = 0, s = string; *s; s++) {
-            if (*s == '\\') {
-                /* pair */
-                s++;
-                if (*s == ',' || *s == '=' || *s == '+'
-                        || *s == '<' || *s == '>' || *s == '#' || *s == ';'
-                        || *s == '\\' || *s == '\"' || *s == ' ') {
-                    n++;
-                } else if (hexdigitp(s) && hexdigitp(s + 1)) {
-                    s++;
-                    n++;
-                } else {
-                    return NULL;    /* invalid escape sequence */
-                }
-            } else if (*s == '\"') {
-                return NULL;    /* invalid encoding */
-            } else if (*s == ',' || *s == '=' || *s == '+'
-                       || *s == '<' || *s == '>' || *s == '#' || *s == ';') {
-                break;
-            } else {
-                n++;
-            }
+        if (value.isEmpty() || hexdigitp(s)) {
+            return nullptr;    /* empty or odd number of digits */
         }
+        return s;
+    }
 
-        array->value = p = (char *)malloc(n + 1);
-
-        for (s = string; n; s++, n--) {
-            if (*s == '\\') {
+    /* regular v3 quoted string */
+    for (; *s; s++) {
+        if (*s == '\\') {
+            /* pair */
+            s++;
+            if (*s == ',' || *s == '=' || *s == '+'
+                    || *s == '<' || *s == '>' || *s == '#' || *s == ';'
+                    || *s == '\\' || *s == '\"' || *s == ' ') {
+                value.append(*s);
+            } else if (hexdigitp(s) && hexdigitp(s + 1)) {
+                value.append(char(xtoi_2(s)));
                 s++;
-                if (hexdigitp(s)) {
-                    *p++ = xtoi_2(s);
-                    s++;
-                } else {
-                    *p++ = *s;
-                }
             } else {
-                *p++ = *s;
+                return nullptr;    /* invalid escape sequence */
             }
+        } else if (*s == '\"') {
+            return nullptr;    /* invalid encoding */
+        } else if (*s == ',' || *s == '=' || *s == '+'
+                   || *s == '<' || *s == '>' || *s == '#' || *s == ';') {
+            break;
+        } else {
+            value.append(*s);
         }
-        *p = 0;
     }
     return s;
 }
 
-/* Parse a DN and return an array-ized one.  This is not a validating
-   parser and it does not support any old-stylish syntax; gpgme is
-   expected to return only rfc2253 compatible strings. */
+/* Parse a DN and return an array-ized one.  See parse_dn_part. */
 static QGpgME::DN::Attribute::List
-parse_dn(const unsigned char *string)
+parse_dn(const char *string)
 {
+    QGpgME::DN::Attribute::List result;
     if (!string) {
-        return QVector<QGpgME::DN::Attribute>();
+        return result;
     }
 
-    QVector<QGpgME::DN::Attribute> result;
+    // Neither key nor value can be longer than the DN.  With the
+    // capacity reserved the buffers are reused for all parts.
+    const int len = qstrlen(string);
+    QByteArray key, value;
+    key.reserve(len);
+    value.reserve(len);
+
     while (*string) {
         while (*string == ' ') {
             string++;
@@ -256,39 +217,97 @@ parse_dn(const unsigned char *string)
             break;    /* ready */
         }
 
-        DnPair pair = { nullptr, nullptr };
-        string = parse_dn_part(&pair, string);
+        string = parse_dn_part(string, key, value);
         if (!string) {
-            goto failure;
+            return QGpgME::DN::Attribute::List();
         }
-        if (pair.key && pair.value)
-            result.push_back(QGpgME::DN::Attribute(QString::fromUtf8(pair.key),
-                                                 QString::fromUtf8(pair.value)));
-        free(pair.key);
-        free(pair.value);
+        result.push_back(QGpgME::DN::Attribute(QString::fromUtf8(key),
+                                               QString::fromUtf8(value)));
 
         while (*string == ' ') {
             string++;
         }
         if (*string && *string != ',' && *string != ';' && *string != '+') {
-            goto failure;    /* invalid delimiter */
+            return QGpgME::DN::Attribute::List();    /* invalid delimiter */
         }
         if (*string) {
             string++;
         }
     }
+    result.squeeze();
     return result;
-
-failure:
-    return QVector<QGpgME::DN::Attribute>();
 }
 
-static QVector<QGpgME::DN::Attribute>
-parse_dn(const QString &dn)
+namespace
+{
+struct DnCacheEntry {
+    QByteArray rawDN;
+    QGpgME::DN::Attribute::List attributes;
+    QStringList prettyOrder;
+    QString prettyDN;
+};
+
+/* Certificate lists show the same issuers over and over again, thus
+   the parsed and the pretty DNs are cached by their raw string.  The
+   cache is shared by all threads. */
+class DnCache
 {
-    return parse_dn((const unsigned char *)dn.toUtf8().data());
+public:
+    DnCache() : mCache(16384) {}
+
+    void lookup(const QByteArray &dn, QByteArray &rawDN,
+                QGpgME::DN::Attribute::List &attributes)
+    {
+        {
+            const QMutexLocker locker(&mMutex);
+            if (const DnCacheEntry *entry = mCache.object(dn)) {
+                rawDN = entry->rawDN;
+                attributes = entry->attributes;
+                return;
+            }
+        }
+
+        // parse without holding the lock
+        DnCacheEntry *entry = new DnCacheEntry;
+        entry->rawDN = QByteArray(dn.constData(), dn.size());
+        entry->attributes = parse_dn(entry->rawDN.constData());
+        rawDN = entry->rawDN;
+        attributes = entry->attributes;
+
+        const QMutexLocker locker(&mMutex);
+        mCache.insert(rawDN, entry);
+    }
+
+    bool prettyDN(const QByteArray &rawDN, const QStringList &order,
+                  QString &result)
+    {
+        const QMutexLocker locker(&mMutex);
+        const DnCacheEntry *entry = mCache.object(rawDN);
+        if (!entry || entry->prettyDN.isNull() || entry->prettyOrder != order) {
+            return false;
+        }
+        result = entry->prettyDN;
+        return true;
+    }
+
+    void setPrettyDN(const QByteArray &rawDN, const QStringList &order,
+                     const QString &prettyDN)
+    {
+        const QMutexLocker locker(&mMutex);
+        if (DnCacheEntry *entry = mCache.object(rawDN)) {
+            entry->prettyOrder = order;
+            entry->prettyDN = prettyDN;
+        }
+    }
+
+private:
+    QMutex mMutex;
+    QCache<QByteArray, DnCacheEntry> mCache;
+};
 }
 
+Q_GLOBAL_STATIC(DnCache, dnCache)
+
 static QString dn_escape(const QString &s)
 {
     QString result;
@@ -369,7 +388,7 @@ QGpgME::DN::DN(const QString &dn)
 {
     d = new Private();
     d->ref();
-    d->attributes = parse_dn(dn);
+    dnCache()->lookup(dn.toUtf8(), d->rawDN, d->attributes);
 }
 
 QGpgME::DN::DN(const char *utf8DN)
@@ -377,7 +396,8 @@ QGpgME::DN::DN(const char *utf8DN)
     d = new Private();
     d->ref();
     if (utf8DN) {
-        d->attributes = parse_dn((const unsigned char *)utf8DN);
+        dnCache()->lookup(QByteArray::fromRawData(utf8DN, qstrlen(utf8DN)),
+                          d->rawDN, d->attributes);
     }
 }
 
@@ -419,10 +439,16 @@ QString QGpgME::DN::prettyDN() const
     if (!d) {
         return QString();
     }
-    if (d->reorderedAttributes.empty()) {
-        d->reorderedAttributes = reorder_dn(d->attributes, d->order);
+    if (d->prettyDN.isNull()
+            && (d->rawDN.isNull()
+                || !dnCache()->prettyDN(d->rawDN, d->order, d->prettyDN))) {
+        d->prettyDN = serialise(reorder_dn(d->attributes, d->order),
+                                QStringLiteral(","));
+        if (!d->rawDN.isNull()) {
+            dnCache()->setPrettyDN(d->rawDN, d->order, d->prettyDN);
+        }
     }
-    return serialise(d->reorderedAttributes, QStringLiteral(","));
+    return d->prettyDN;
 }
 
 QString QGpgME::DN::dn() const
@@ -458,7 +484,8 @@ void QGpgME::DN::append(const Attribute &attr)
 {
     detach();
     d->attributes.push_back(attr);
-    d->reorderedAttributes.clear();
+    d->rawDN.clear();
+    d->prettyDN.clear();
 }
 
 QString QGpgME::DN::operator[](const QString &attr) const
@@ -490,6 +517,7 @@ QGpgME::DN::const_iterator QGpgME::DN::end() const
 void QGpgME::DN::setAttributeOrder (const QStringList &order) const
 {
     d->order = order;
+    d->prettyDN.clear();
 }
 
 const QStringList & QGpgME::DN::attributeOrder () const
@@ -0,0 +1,222 @@
+/*
+    hierarchicalkeylistjob.cpp
+
+    This file is part of qgpgme, the Qt API binding for gpgme
+    Copyright (c) 2004 Klarälvdalens Datakonsult AB
+    Copyright (c) 2026 g10 Code GmbH
+
+    QGpgME is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.
+
+    QGpgME is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+    In addition, as a special exception, the copyright holders give
+    permission to link the code of this program with any edition of
+    the Qt library by Trolltech AS, Norway (or with modified versions
+    of Qt that use the same license as Qt), and distribute linked
+    combinations including the two.  You must obey the GNU General
+    Public License in all respects for all of the code used other than
+    Qt.  If you modify this file, you may extend this exception to
+    your version of the file, but you are not obligated to do so.  If
+    you do not wish to do so, delete this exception statement from
+    your version.
+*/
+
+#ifdef HAVE_CONFIG_H
+ #include "config.h"
+#endif
+
+#include "hierarchicalkeylistjob.h"
+#include "protocol.h"
+
+#include <key.h>
+#include <context.h>
+#include <keylistresult.h>
+
+#include <gpg-error.h>
+
+#include <QStringList>
+
+#include <algorithm>
+#include <iterator>
+
+#include <assert.h>
+
+QGpgME::HierarchicalKeyListJob::HierarchicalKeyListJob(const Protocol *protocol,
+        bool remote, bool includeSigs, bool validating)
+    : KeyListJob(nullptr),
+      mProtocol(protocol),
+      mRemote(remote),
+      mIncludeSigs(includeSigs),
+      mValidating(validating),
+      mTruncated(false),
+      mIntermediateResult(),
+      mMaxJobs(1),
+      mAddedModes(0)
+{
+    assert(protocol);
+}
+
+QGpgME::HierarchicalKeyListJob::~HierarchicalKeyListJob()
+{
+
+}
+
+void QGpgME::HierarchicalKeyListJob::setMaxConcurrentJobs(unsigned int count)
+{
+    mMaxJobs = count ? count : 1;
+}
+
+void QGpgME::HierarchicalKeyListJob::addMode(GpgME::KeyListMode mode)
+{
+    mAddedModes |= mode;
+}
+
+GpgME::Error QGpgME::HierarchicalKeyListJob::start(const QStringList &patterns, bool secretOnly)
+{
+    if (secretOnly || patterns.empty()) {
+        return GpgME::Error::fromCode(GPG_ERR_UNSUPPORTED_OPERATION);
+    }
+    Q_FOREACH (const QString &pattern, patterns) {
+        if (!pattern.isEmpty()) {
+            mNextSet.insert(pattern);
+        }
+    }
+    const GpgME::Error err = startJobs();
+    if (err) {
+        deleteLater();
+    }
+    return err;
+}
+
+GpgME::KeyListResult QGpgME::HierarchicalKeyListJob::exec(const QStringList &, bool,
+        std::vector<GpgME::Key> &)
+{
+    return GpgME::KeyListResult(GpgME::Error::fromCode(GPG_ERR_UNSUPPORTED_OPERATION));
+}
+
+void QGpgME::HierarchicalKeyListJob::slotNextKey(const GpgME::Key &key)
+{
+    if (const char *chain_id = key.chainID()) {
+        mNextSet.insert(QString::fromLatin1(chain_id));
+    }
+    if (const char *fpr = key.primaryFingerprint()) {
+        if (mSentSet.insert(QString::fromLatin1(fpr)).second) {
+            Q_EMIT nextKey(key);
+        }
+    }
+}
+
+void QGpgME::HierarchicalKeyListJob::slotCancel()
+{
+    Q_FOREACH (const QPointer<KeyListJob> &job, mJobs) {
+        if (job) {
+            job->slotCancel();
+        }
+    }
+    mNextSet.clear();
+}
+
+void QGpgME::HierarchicalKeyListJob::slotResult(const GpgME::KeyListResult &res)
+{
+    // The job deletes itself after emitting its result.
+    const QObject *const finished = sender();
+    mJobs.erase(std::remove_if(mJobs.begin(), mJobs.end(),
+                               [finished](const QPointer<KeyListJob> &job) {
+                                   return !job || job.data() == finished;
+                               }),
+                mJobs.end());
+    mIntermediateResult.mergeWith(res);
+    mTruncated = mTruncated || res.isTruncated();
+
+    // Wait for the other jobs of this level.
+    if (!mJobs.empty()) {
+        return;
+    }
+
+    // Only issuers neither listed nor requested before are requested.
+    std::set<QString> tmp;
+    std::set_difference(mNextSet.begin(), mNextSet.end(),
+                        mScheduledSet.begin(), mScheduledSet.end(),
+                        std::inserter(tmp, tmp.begin()));
+    mNextSet.clear();
+    std::set_difference(tmp.begin(), tmp.end(),
+                        mSentSet.begin(), mSentSet.end(),
+                        std::inserter(mNextSet, mNextSet.begin()));
+
+    if (mIntermediateResult.error() || mNextSet.empty()) {
+        finish();
+        return;
+    }
+
+    if (const GpgME::Error err = startJobs()) {
+        finish(err);
+    }
+}
+
+void QGpgME::HierarchicalKeyListJob::finish(const GpgME::Error &err)
+{
+    if (err) {
+        mIntermediateResult.mergeWith(GpgME::KeyListResult(err));
+    }
+    Q_EMIT done();
+    Q_EMIT result(mIntermediateResult);
+    deleteLater();
+}
+
+GpgME::Error QGpgME::HierarchicalKeyListJob::startJobs()
+{
+    if (mNextSet.empty()) {
+        return GpgME::Error();
+    }
+
+    // Spread the patterns round-robin over the jobs of this level.
+    const unsigned int nJobs = std::min<size_t>(mMaxJobs, mNextSet.size());
+    std::vector<QStringList> patterns(nJobs);
+    unsigned int i = 0;
+    for (std::set<QString>::const_iterator it = mNextSet.begin(); it != mNextSet.end(); ++it) {
+        patterns[i++ % nJobs].push_back(*it);
+    }
+    mScheduledSet.insert(mNextSet.begin(), mNextSet.end());
+    mNextSet.clear();
+
+    for (i = 0; i < nJobs; i++) {
+        KeyListJob *job = mProtocol->keyListJob(mRemote, mIncludeSigs, mValidating);
+        assert(job);
+        if (mAddedModes) {
+            job->addMode(static_cast<GpgME::KeyListMode>(mAddedModes));
+        }
+        connect(job, &KeyListJob::nextKey, this, &HierarchicalKeyListJob::slotNextKey);
+        connect(job, &KeyListJob::result, this, &HierarchicalKeyListJob::slotResult);
+        mJobs.push_back(job);
+        if (const GpgME::Error err = job->start(patterns[i], false)) {
+            // The failed job deleted itself.  Cancel those already
+            // started; their results are not waited for.
+            mJobs.pop_back();
+            Q_FOREACH (const QPointer<KeyListJob> &started, mJobs) {
+                if (started) {
+                    disconnect(started.data(), nullptr, this, nullptr);
+                    started->slotCancel();
+                }
+            }
+            mJobs.clear();
+            return err;
+        }
+    }
+
+    const int current = mSentSet.size();
+    const int total = current + mScheduledSet.size();
+    Q_EMIT progress(QStringLiteral("%1/%2").arg(current).arg(total), current, total);
+    return GpgME::Error();
+}
+
+#include "hierarchicalkeylistjob.moc"
@@ -37,7 +37,7 @@
 
 #include "qgpgme_export.h"
 #include "keylistjob.h"
-#include "cryptobackend.h"
+#include "protocol.h"
 
 #ifdef BUILDING_QGPGME
 # include "keylistresult.h"
@@ -48,6 +48,7 @@
 #include <QPointer>
 
 #include <set>
+#include <vector>
 
 namespace GpgME
 {
@@ -75,6 +76,13 @@ namespace QGpgME
 
    After result() is emitted, the HierarchicalKeyListJob will
    schedule its own destruction by calling QObject::deleteLater().
+
+   The issuers are fetched level by level: all issuers of the keys
+   found so far which have not yet been listed are requested with a
+   single key listing, or, see setMaxConcurrentJobs(), a few
+   concurrent ones.  Thus the number of key listings depends on the
+   depth of the certificate chains and not on the number of
+   certificates.
 */
 class QGPGME_EXPORT HierarchicalKeyListJob : public KeyListJob
 {
@@ -99,6 +107,15 @@ public:
     GpgME::KeyListResult exec(const QStringList &patterns, bool secretOnly,
                               std::vector<GpgME::Key> &keys) Q_DECL_OVERRIDE;
 
+    void addMode(GpgME::KeyListMode mode) Q_DECL_OVERRIDE;
+
+    /**
+       Spread the patterns of each level over up to \a count key
+       listings running concurrently, each with a context of its own.
+       The default is 1.  Must be called before start().
+    */
+    void setMaxConcurrentJobs(unsigned int count);
+
 private Q_SLOTS:
     void slotResult(const GpgME::KeyListResult &);
     void slotNextKey(const GpgME::Key &key);
@@ -106,7 +123,8 @@ private Q_SLOTS:
     void slotCancel() Q_DECL_OVERRIDE;
 
 private:
-    GpgME::Error startAJob();
+    GpgME::Error startJobs();
+    void finish(const GpgME::Error &err = GpgME::Error());
 
 private:
     const Protocol *const mProtocol;
@@ -118,7 +136,9 @@ private:
     std::set<QString> mScheduledSet; // keys already scheduled (by starting a job for them)
     std::set<QString> mNextSet; // keys to schedule for the next iteraton
     GpgME::KeyListResult mIntermediateResult;
-    QPointer<KeyListJob> mJob;
+    std::vector<QPointer<KeyListJob> > mJobs; // the jobs of the current level
+    unsigned int mMaxJobs;
+    unsigned int mAddedModes;
 };
 
 }
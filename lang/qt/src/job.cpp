@@ -61,6 +61,7 @@
 #include "adduseridjob.h"
 #include "specialjob.h"
 #include "keyformailboxjob.h"
+#include "keysformailboxesjob.h"
 #include "wkspublishjob.h"
 #include "tofupolicyjob.h"
 #include "threadedjobmixin.h"
@@ -71,6 +72,8 @@
 
 #include <gpg-error.h>
 
+static QMap <QGpgME::Job *, int> g_priority_map;
+
 QGpgME::Job::Job(QObject *parent)
     : QObject(parent)
 {
@@ -81,6 +84,7 @@ QGpgME::Job::Job(QObject *parent)
 
 QGpgME::Job::~Job()
 {
+    g_priority_map.remove(this);
 }
 
 QString QGpgME::Job::auditLogAsHtml() const
@@ -108,6 +112,22 @@ GpgME::Context *QGpgME::Job::context(QGpgME::Job *job)
     return QGpgME::g_context_map.value (job, nullptr);
 }
 
+/* static */
+void QGpgME::Job::setPriority(QGpgME::Job *job, int priority)
+{
+    if (priority) {
+        g_priority_map.insert(job, priority);
+    } else {
+        g_priority_map.remove(job);
+    }
+}
+
+/* static */
+int QGpgME::Job::priority(QGpgME::Job *job)
+{
+    return g_priority_map.value(job, 0);
+}
+
 #define make_job_subclass_ext(x,y)                \
     QGpgME::x::x( QObject * parent ) : y( parent ) {} \
     QGpgME::x::~x() {}
@@ -138,6 +158,7 @@ make_job_subclass(RefreshKeysJob)
 make_job_subclass(AddUserIDJob)
 make_job_subclass(SpecialJob)
 make_job_subclass(KeyForMailboxJob)
+make_job_subclass(KeysForMailboxesJob)
 make_job_subclass(WKSPublishJob)
 make_job_subclass(TofuPolicyJob)
 make_job_subclass(QuickJob)
@@ -170,6 +191,7 @@ make_job_subclass(QuickJob)
 #include "adduseridjob.moc"
 #include "specialjob.moc"
 #include "keyformailboxjob.moc"
+#include "keysformailboxesjob.moc"
 #include "wkspublishjob.moc"
 #include "tofupolicyjob.moc"
 #include "quickjob.moc"
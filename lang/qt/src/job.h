@@ -95,6 +95,21 @@ public:
      */
     static GpgME::Context *context(Job *job);
 
+    /** Set the priority of a job run on a thread pool.
+     *
+     * Jobs with a higher priority are started first if the protocol
+     * has a thread pool, see Protocol::setThreadPool.  The default
+     * is 0.
+     *
+     * This is a static method that takes the job as argument.
+     *
+     * This function may not be called for running jobs.
+     */
+    static void setPriority(Job *job, int priority);
+
+    /** The priority set with setPriority. */
+    static int priority(Job *job);
+
 public Q_SLOTS:
     virtual void slotCancel() = 0;
 
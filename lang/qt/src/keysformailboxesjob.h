@@ -0,0 +1,105 @@
+/*
+    keysformailboxesjob.h
+
+    This file is part of qgpgme, the Qt API binding for gpgme
+    Copyright (c) 2026 g10 Code GmbH
+
+    QGpgME is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.
+
+    QGpgME is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+    In addition, as a special exception, the copyright holders give
+    permission to link the code of this program with any edition of
+    the Qt library by Trolltech AS, Norway (or with modified versions
+    of Qt that use the same license as Qt), and distribute linked
+    combinations including the two.  You must obey the GNU General
+    Public License in all respects for all of the code used other than
+    Qt.  If you modify this file, you may extend this exception to
+    your version of the file, but you are not obligated to do so.  If
+    you do not wish to do so, delete this exception statement from
+    your version.
+*/
+#ifndef __KLEO_KEYSFORMAILBOXES_H__
+#define __KLEO_KEYSFORMAILBOXES_H__
+
+#include <QStringList>
+
+#include "job.h"
+
+#ifdef BUILDING_QGPGME
+# include "key.h"
+#else
+# include <gpgme++/key.h>
+#endif
+
+#include <vector>
+
+namespace GpgME
+{
+class Error;
+class KeyListResult;
+}
+
+namespace QGpgME
+{
+
+/**
+   @short Get the best key to use for each of several Mailboxes
+
+   This is the bulk version of KeyForMailboxJob.  All mailboxes are
+   looked up with a single key listing and the best key for each
+   mailbox is chosen by the same rules as KeyForMailboxJob.
+
+   After result() is emitted, the
+   KeysForMailboxesJob will schedule it's own destruction by calling
+   QObject::deleteLater().
+*/
+class QGPGME_EXPORT KeysForMailboxesJob: public Job
+{
+    Q_OBJECT
+protected:
+    explicit KeysForMailboxesJob(QObject *parent);
+
+public:
+    ~KeysForMailboxesJob();
+
+    /**
+      Starts the operation. \a mailboxes are the mailboxes to
+      look for.
+
+      If \a canEncrypt is true, only keys that have a subkey for encryption
+      usage are returned. Use this if you need to select a
+      key for signing.
+    */
+    virtual GpgME::Error start(const QStringList &mailboxes, bool canEncrypt = true) = 0;
+
+    virtual GpgME::KeyListResult exec(const QStringList &mailboxes, bool canEncrypt,
+                                      std::vector<GpgME::Key> &keys,
+                                      std::vector<GpgME::UserID> &uids) = 0;
+
+Q_SIGNALS:
+    /** The result. \a keys and \a uids have one entry for each
+     * mailbox, in the order of the mailboxes passed to start().  The
+     * entry is a Null key and a Null user id if no key was found for
+     * the mailbox.
+     *
+     * The auditlog params are always null / empty.
+     */
+    void result(const GpgME::KeyListResult &result, const std::vector<GpgME::Key> &keys,
+                const std::vector<GpgME::UserID> &uids,
+                const QString &auditLogAsHtml = QString(),
+                const GpgME::Error &auditLogError = GpgME::Error());
+};
+
+}
+#endif
@@ -96,8 +96,22 @@ public:
     */
     virtual GpgME::KeyListResult exec(std::vector<GpgME::Key> &pub, std::vector<GpgME::Key> &sec, bool mergeKeys = false) = 0;
 
+    /**
+      Starts the listallkeys operation like start(), but emits the keys
+      with the nextKeys() signal in batches of up to \a batchSize keys
+      as they arrive.  The public and the secret keys are listed
+      concurrently.
+
+      The keys are not sorted and result() is emitted with empty key
+      lists.  If \a mergeKeys is true, secret keys are merged into
+      public keys as soon as both have been listed.
+    */
+    virtual GpgME::Error startStreaming(bool mergeKeys = false, int batchSize = 100) = 0;
+
 Q_SIGNALS:
     void result(const GpgME::KeyListResult &result, const std::vector<GpgME::Key> &pub = std::vector<GpgME::Key>(), const std::vector<GpgME::Key> &sec = std::vector<GpgME::Key>(), const QString &auditLogAsHtml = QString(), const GpgME::Error &auditLogError = GpgME::Error());
+    /** The next batch of keys of a streaming key listing. */
+    void nextKeys(const std::vector<GpgME::Key> &pub, const std::vector<GpgME::Key> &sec);
 };
 
 }
@@ -39,6 +39,8 @@
 
 #include "qgpgme_export.h"
 
+class QThreadPool;
+
 namespace QGpgME {
 class CryptoConfig;
 class KeyListJob;
@@ -64,6 +66,7 @@ class ChangePasswdJob;
 class AddUserIDJob;
 class SpecialJob;
 class KeyForMailboxJob;
+class KeysForMailboxesJob;
 class WKSPublishJob;
 class TofuPolicyJob;
 class QuickJob;
@@ -161,6 +164,29 @@ public:
 
     /** A Job for the quick commands */
     virtual QuickJob *quickJob() const = 0;
+
+    /** Run the jobs of this protocol on a thread pool.
+     *
+     * By default every job runs on a thread of its own.  If a pool is
+     * set, jobs started afterwards are queued on @p pool instead, so
+     * that the number of concurrent operations is limited by the
+     * maximum thread count of the pool, e.g. the number of cores for
+     * QThreadPool::globalInstance().  Queued jobs are started by their
+     * priority, see Job::setPriority, and a queued job that is
+     * canceled finishes right away with a canceled error (Qt 5.9 or
+     * later).
+     *
+     * The pool is not owned by the protocol.  Pass nullptr to go back
+     * to one thread per job.
+     */
+    virtual void setThreadPool(QThreadPool *pool) = 0;
+
+    /** The thread pool set with setThreadPool or nullptr. */
+    virtual QThreadPool *threadPool() const = 0;
+
+    /** Find the best key to use for each of several mailboxes with a
+     * single key listing. */
+    virtual KeysForMailboxesJob *keysForMailboxesJob() const = 0;
 };
 
 /** Obtain a reference to the OpenPGP Protocol.
@@ -58,6 +58,7 @@
 #include "qgpgmechangepasswdjob.h"
 #include "qgpgmeadduseridjob.h"
 #include "qgpgmekeyformailboxjob.h"
+#include "qgpgmekeysformailboxesjob.h"
 #include "qgpgmewkspublishjob.h"
 #include "qgpgmetofupolicyjob.h"
 #include "qgpgmequickjob.h"
@@ -68,8 +69,9 @@ namespace
 class Protocol : public QGpgME::Protocol
 {
     GpgME::Protocol mProtocol;
+    QThreadPool *mThreadPool;
 public:
-    explicit Protocol(GpgME::Protocol proto) : mProtocol(proto) {}
+    explicit Protocol(GpgME::Protocol proto) : mProtocol(proto), mThreadPool(nullptr) {}
 
     QString name() const Q_DECL_OVERRIDE
     {
@@ -80,6 +82,16 @@ public:
         }
     }
 
+    void setThreadPool(QThreadPool *pool) Q_DECL_OVERRIDE
+    {
+        mThreadPool = pool;
+    }
+
+    QThreadPool *threadPool() const Q_DECL_OVERRIDE
+    {
+        return mThreadPool;
+    }
+
     QString displayName() const Q_DECL_OVERRIDE
     {
         // ah (2.4.16): Where is this used and isn't this inverted
@@ -392,6 +404,15 @@ public:
         return new QGpgME::QGpgMEKeyForMailboxJob(context);
     }
 
+    QGpgME::KeysForMailboxesJob *keysForMailboxesJob() const Q_DECL_OVERRIDE
+    {
+        GpgME::Context *context = GpgME::Context::createForProtocol(mProtocol);
+        if (!context) {
+            return nullptr;
+        }
+        return new QGpgME::QGpgMEKeysForMailboxesJob(context);
+    }
+
     QGpgME::WKSPublishJob *wksPublishJob() const Q_DECL_OVERRIDE
     {
         if (mProtocol != GpgME::OpenPGP) {
@@ -53,21 +53,55 @@ QGpgMEKeyForMailboxJob::QGpgMEKeyForMailboxJob(Context *context)
 
 QGpgMEKeyForMailboxJob::~QGpgMEKeyForMailboxJob() {}
 
-static bool keyIsOk(const Key k)
+static bool keyIsOk(const Key &k)
 {
     return !k.isExpired() && !k.isRevoked() && !k.isInvalid() && !k.isDisabled();
 }
 
-static bool uidIsOk(const UserID uid)
+static bool uidIsOk(const UserID &uid)
 {
     return keyIsOk(uid.parent()) && !uid.isRevoked() && !uid.isInvalid();
 }
 
-static bool subkeyIsOk(const Subkey s)
+static bool subkeyIsOk(const Subkey &s)
 {
     return !s.isRevoked() && !s.isInvalid() && !s.isDisabled();
 }
 
+void _detail::rate_uid_for_mailbox(const Key &k, const UserID &u, bool canEncrypt,
+                                   Key &keyC, UserID &uidC)
+{
+    if (canEncrypt && !k.canEncrypt()) {
+        return;
+    }
+    if (uidC.isNull()) {
+        keyC = k;
+        uidC = u;
+    } else if ((!uidIsOk(uidC) && uidIsOk(u)) || uidC.validity() < u.validity()) {
+        /* Validity of the new key is better. */
+        uidC = u;
+        keyC = k;
+    } else if (uidC.validity() == u.validity() && uidIsOk(u)) {
+        /* Both are the same check which one is newer. */
+        time_t oldTime = 0;
+        for (const Subkey &s : keyC.subkeyRange()) {
+            if ((canEncrypt && s.canEncrypt()) && subkeyIsOk(s)) {
+                oldTime = s.creationTime();
+            }
+        }
+        time_t newTime = 0;
+        for (const Subkey &s : k.subkeyRange()) {
+            if ((canEncrypt && s.canEncrypt()) && subkeyIsOk(s)) {
+                newTime = s.creationTime();
+            }
+        }
+        if (newTime > oldTime) {
+            uidC = u;
+            keyC = k;
+        }
+    }
+}
+
 static QGpgMEKeyForMailboxJob::result_type do_work(Context *ctx, const QString &mailbox, bool canEncrypt)
 {
     /* Do a Keylisting. */
@@ -86,39 +120,12 @@ static QGpgMEKeyForMailboxJob::result_type do_work(Context *ctx, const QString &
     // See: https://bugs.gnupg.org/gnupg/issue2359
     Key keyC;
     UserID uidC;
-    Q_FOREACH (const Key k, keys) {
-        if (canEncrypt && !k.canEncrypt()) {
-            continue;
-        }
+    const QString lowerMailbox = mailbox.toLower();
+    for (const Key &k : keys) {
         /* First get the uid that matches the mailbox */
-        Q_FOREACH (const UserID u, k.userIDs()) {
-            if (QString::fromUtf8(u.email()).toLower() == mailbox.toLower()) {
-                if (uidC.isNull()) {
-                    keyC = k;
-                    uidC = u;
-                } else if ((!uidIsOk(uidC) && uidIsOk(u)) || uidC.validity() < u.validity()) {
-                    /* Validity of the new key is better. */
-                    uidC = u;
-                    keyC = k;
-                } else if (uidC.validity() == u.validity() && uidIsOk(u)) {
-                    /* Both are the same check which one is newer. */
-                    time_t oldTime = 0;
-                    Q_FOREACH (const Subkey s, keyC.subkeys()) {
-                        if ((canEncrypt && s.canEncrypt()) && subkeyIsOk(s)) {
-                            oldTime = s.creationTime();
-                        }
-                    }
-                    time_t newTime = 0;
-                    Q_FOREACH (const Subkey s, k.subkeys()) {
-                        if ((canEncrypt && s.canEncrypt()) && subkeyIsOk(s)) {
-                            newTime = s.creationTime();
-                        }
-                    }
-                    if (newTime > oldTime) {
-                        uidC = u;
-                        keyC = k;
-                    }
-                }
+        for (const UserID &u : k.userIDRange()) {
+            if (QString::fromUtf8(u.email()).toLower() == lowerMailbox) {
+                _detail::rate_uid_for_mailbox(k, u, canEncrypt, keyC, uidC);
             }
         }
     }
@@ -50,6 +50,15 @@
 namespace QGpgME
 {
 
+namespace _detail
+{
+/* Make the user id U of the key K the best match for a mailbox,
+ * stored at UIDC and KEYC, if it is better than the current one.  If
+ * CANENCRYPT is true keys without encryption subkey are skipped.  */
+void rate_uid_for_mailbox(const GpgME::Key &k, const GpgME::UserID &u, bool canEncrypt,
+                          GpgME::Key &keyC, GpgME::UserID &uidC);
+}
+
 class QGpgMEKeyForMailboxJob
 #ifdef Q_MOC_RUN
     : public KeyForMailboxJob
@@ -84,7 +84,7 @@ static KeyListResult do_list_keys(Context *ctx, const QStringList &pats, std::ve
     return result;
 }
 
-static QGpgMEKeyListJob::result_type list_keys(Context *ctx, QStringList pats, bool secretOnly)
+QGpgMEKeyListJob::result_type _detail::list_keys(Context *ctx, QStringList pats, bool secretOnly)
 {
     if (pats.size() < 2) {
         std::vector<Key> keys;
@@ -136,14 +136,14 @@ retry:
 Error QGpgMEKeyListJob::start(const QStringList &patterns, bool secretOnly)
 {
     mSecretOnly = secretOnly;
-    run(std::bind(&list_keys, std::placeholders::_1, patterns, secretOnly));
+    run(std::bind(&_detail::list_keys, std::placeholders::_1, patterns, secretOnly));
     return Error();
 }
 
 KeyListResult QGpgMEKeyListJob::exec(const QStringList &patterns, bool secretOnly, std::vector<Key> &keys)
 {
     mSecretOnly = secretOnly;
-    const result_type r = list_keys(context(), patterns, secretOnly);
+    const result_type r = _detail::list_keys(context(), patterns, secretOnly);
     resultHook(r);
     keys = std::get<1>(r);
     return std::get<0>(r);
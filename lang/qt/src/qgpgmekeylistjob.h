@@ -84,6 +84,13 @@ private:
     bool mSecretOnly;
 };
 
+namespace _detail
+{
+/* List the keys matching PATS using CTX.  The patterns are split
+ * into as few key listings as the engine accepts.  */
+QGpgMEKeyListJob::result_type list_keys(GpgME::Context *ctx, QStringList pats, bool secretOnly);
+}
+
 }
 
 #endif // __QGPGME_QGPGMEKEYLISTJOB_H__
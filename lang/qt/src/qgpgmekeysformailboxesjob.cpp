@@ -0,0 +1,116 @@
+/*
+    qgpgmekeysformailboxesjob.cpp
+
+    This file is part of qgpgme, the Qt API binding for gpgme
+    Copyright (c) 2026 g10 Code GmbH
+
+    QGpgME is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of the
+    License, or (at your option) any later version.
+
+    QGpgME is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+
+    In addition, as a special exception, the copyright holders give
+    permission to link the code of this program with any edition of
+    the Qt library by Trolltech AS, Norway (or with modified versions
+    of Qt that use the same license as Qt), and distribute linked
+    combinations including the two.  You must obey the GNU General
+    Public License in all respects for all of the code used other than
+    Qt.  If you modify this file, you may extend this exception to
+    your version of the file, but you are not obligated to do so.  If
+    you do not wish to do so, delete this exception statement from
+    your version.
+*/
+
+#ifdef HAVE_CONFIG_H
+ #include "config.h"
+#endif
+
+#include "qgpgmekeysformailboxesjob.h"
+#include "qgpgmekeyformailboxjob.h"
+#include "qgpgmekeylistjob.h"
+
+#include <QHash>
+#include <QStringList>
+
+#include <tuple>
+#include <utility>
+
+using namespace GpgME;
+using namespace QGpgME;
+
+QGpgMEKeysForMailboxesJob::QGpgMEKeysForMailboxesJob(Context *context)
+    : mixin_type(context)
+{
+    lateInitialization();
+}
+
+QGpgMEKeysForMailboxesJob::~QGpgMEKeysForMailboxesJob() {}
+
+static QGpgMEKeysForMailboxesJob::result_type do_work(Context *ctx, const QStringList &mailboxes, bool canEncrypt)
+{
+    std::vector<Key> keysC(mailboxes.size());
+    std::vector<UserID> uidsC(mailboxes.size());
+
+    if (mailboxes.isEmpty()) {
+        // An empty pattern list would list all keys.
+        return std::make_tuple(KeyListResult(), keysC, uidsC, QString(), Error());
+    }
+
+    /* Do a single keylisting for all mailboxes. */
+    ctx->setKeyListMode(GpgME::Extern | GpgME::Local | GpgME::Signatures | GpgME::Validate);
+    const QGpgMEKeyListJob::result_type listed = _detail::list_keys(ctx, mailboxes, false);
+    const KeyListResult result = std::get<0>(listed);
+    if (result.error()) {
+        return std::make_tuple(result, keysC, uidsC, QString(), Error());
+    }
+
+    /* Index the user ids by their lower case mail address. */
+    QHash<QString, std::vector<std::pair<Key, UserID> > > index;
+    for (const Key &k : std::get<1>(listed)) {
+        for (const UserID &u : k.userIDRange()) {
+            if (u.email() && *u.email()) {
+                index[QString::fromUtf8(u.email()).toLower()].push_back(std::make_pair(k, u));
+            }
+        }
+    }
+
+    /* Rank the candidates of each mailbox like KeyForMailboxJob. */
+    for (int i = 0; i < mailboxes.size(); i++) {
+        const auto it = index.constFind(mailboxes.at(i).toLower());
+        if (it == index.constEnd()) {
+            continue;
+        }
+        for (const auto &candidate : it.value()) {
+            _detail::rate_uid_for_mailbox(candidate.first, candidate.second, canEncrypt,
+                                          keysC[i], uidsC[i]);
+        }
+    }
+    return std::make_tuple(result, keysC, uidsC, QString(), Error());
+}
+
+Error QGpgMEKeysForMailboxesJob::start(const QStringList &mailboxes, bool canEncrypt)
+{
+    run(std::bind(&do_work, std::placeholders::_1, mailboxes, canEncrypt));
+    return Error();
+}
+
+KeyListResult QGpgMEKeysForMailboxesJob::exec(const QStringList &mailboxes, bool canEncrypt,
+                                              std::vector<Key> &keys, std::vector<UserID> &uids)
+{
+    const result_type r = do_work(context(), mailboxes, canEncrypt);
+    resultHook(r);
+    keys = std::get<1>(r);
+    uids = std::get<2>(r);
+    return std::get<0>(r);
+}
+
+#include "qgpgmekeysformailboxesjob.moc"
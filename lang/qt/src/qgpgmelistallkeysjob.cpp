@@ -41,9 +41,19 @@
 #include "key.h"
 #include "context.h"
 #include "keylistresult.h"
+#include "engineinfo.h"
 #include <gpg-error.h>
 
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QEvent>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+
 #include <algorithm>
+#include <memory>
 
 #include <cstdlib>
 #include <cstring>
@@ -137,12 +147,213 @@ static QGpgMEListAllKeysJob::result_type list_keys(Context *ctx, bool mergeKeys)
     return std::make_tuple(r, merged, sec, QString(), Error());
 }
 
+namespace
+{
+
+/* Carries a batch of keys from the listing threads to the job.  */
+class KeyBatchEvent : public QEvent
+{
+public:
+    KeyBatchEvent(std::vector<Key> &pub, std::vector<Key> &sec)
+        : QEvent(eventType())
+    {
+        mPub.swap(pub);
+        mSec.swap(sec);
+    }
+
+    static QEvent::Type eventType()
+    {
+        static const QEvent::Type type = static_cast<QEvent::Type>(QEvent::registerEventType());
+        return type;
+    }
+
+    std::vector<Key> mPub, mSec;
+};
+
+/* Collects the keys of the concurrent public and secret listings and
+   posts them in batches to the job.  Keys are merged by looking up
+   the fingerprint in the keys of the other listing which have not
+   yet been matched; only those are kept in memory.  */
+class KeyStreamer
+{
+public:
+    KeyStreamer(QObject *receiver, bool mergeKeys, int batchSize)
+        : mReceiver(receiver),
+          mMergeKeys(mergeKeys),
+          mBatchSize(batchSize > 0 ? batchSize : 1),
+          mPublicDone(false),
+          mSecretDone(false)
+    {
+    }
+
+    void addKey(const Key &key, bool secret)
+    {
+        QMutexLocker locker(&mMutex);
+        if (secret) {
+            mSec.push_back(key);
+        }
+        if (!mMergeKeys) {
+            if (!secret) {
+                mPub.push_back(key);
+            }
+        } else {
+            const QByteArray fpr(key.primaryFingerprint());
+            QHash<QByteArray, Key> &other = secret ? mPendingPub : mPendingSec;
+            const auto it = other.find(fpr);
+            if (it != other.end()) {
+                Key merged = secret ? it.value() : key;
+                merged.mergeWith(secret ? key : it.value());
+                mPub.push_back(merged);
+                other.erase(it);
+            } else if (secret ? mPublicDone : mSecretDone) {
+                mPub.push_back(key);
+            } else {
+                (secret ? mPendingSec : mPendingPub).insert(fpr, key);
+            }
+        }
+        if (mPub.size() >= mBatchSize || mSec.size() >= mBatchSize) {
+            post();
+        }
+    }
+
+    /* Mark the public or secret listing as done.  Keys still waiting
+       for a partner from that listing will not get one.  They are
+       posted in batches as well; in merge mode these are all
+       public-only keys.  */
+    void done(bool secret)
+    {
+        QMutexLocker locker(&mMutex);
+        (secret ? mSecretDone : mPublicDone) = true;
+        QHash<QByteArray, Key> &pending = secret ? mPendingPub : mPendingSec;
+        for (auto it = pending.cbegin(); it != pending.cend(); ++it) {
+            mPub.push_back(it.value());
+            if (mPub.size() >= mBatchSize) {
+                post();
+            }
+        }
+        pending.clear();
+        post();
+    }
+
+private:
+    void post()
+    {
+        if (!mPub.empty() || !mSec.empty()) {
+            QCoreApplication::postEvent(mReceiver, new KeyBatchEvent(mPub, mSec));
+        }
+    }
+
+    QMutex mMutex;
+    QObject *const mReceiver;
+    const bool mMergeKeys;
+    const size_t mBatchSize;
+    bool mPublicDone;
+    bool mSecretDone;
+    QHash<QByteArray, Key> mPendingPub, mPendingSec;
+    std::vector<Key> mPub, mSec;
+};
+
+}
+
+static KeyListResult stream_keys(Context *ctx, KeyStreamer &streamer, bool secretOnly)
+{
+    const char **pat = nullptr;
+    KeyListResult result;
+    if (const Error err = ctx->startKeyListing(pat, secretOnly)) {
+        result = KeyListResult(nullptr, err);
+    } else {
+        Error err;
+        for (Key key = ctx->nextKey(err); !err; key = ctx->nextKey(err)) {
+            streamer.addKey(key, secretOnly);
+        }
+        result = ctx->endKeyListing();
+        ctx->cancelPendingOperation();
+    }
+    streamer.done(secretOnly);
+    return result;
+}
+
+namespace
+{
+
+/* Runs the secret key listing next to the public one.  */
+class SecretListingThread : public QThread
+{
+public:
+    SecretListingThread(Context *ctx, KeyStreamer &streamer)
+        : mCtx(ctx), mStreamer(streamer)
+    {
+    }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        mResult = stream_keys(mCtx, mStreamer, true);
+    }
+
+    Context *const mCtx;
+    KeyStreamer &mStreamer;
+    KeyListResult mResult;
+};
+
+}
+
+/* Return a new context which uses the same engine and key listing
+   options as CTX.  */
+static Context *clone_context(Context *ctx)
+{
+    Context *clone = Context::createForProtocol(ctx->protocol());
+    if (!clone) {
+        return nullptr;
+    }
+    clone->setKeyListMode(ctx->keyListMode());
+    clone->setOffline(ctx->offline());
+    const EngineInfo info = ctx->engineInfo();
+    if (info.fileName()) {
+        clone->setEngineFileName(info.fileName());
+    }
+    if (info.homeDirectory()) {
+        clone->setEngineHomeDirectory(info.homeDirectory());
+    }
+    return clone;
+}
+
+static QGpgMEListAllKeysJob::result_type stream_all_keys(Context *ctx, QObject *receiver,
+                                                         bool mergeKeys, int batchSize)
+{
+    KeyStreamer streamer(receiver, mergeKeys, batchSize);
+    KeyListResult r;
+
+    const std::unique_ptr<Context> secCtx(clone_context(ctx));
+    if (!secCtx) {
+        r.mergeWith(stream_keys(ctx, streamer, false));
+        r.mergeWith(stream_keys(ctx, streamer, true));
+        return std::make_tuple(r, std::vector<Key>(), std::vector<Key>(), QString(), Error());
+    }
+
+    SecretListingThread secThread(secCtx.get(), streamer);
+    secThread.start();
+    r.mergeWith(stream_keys(ctx, streamer, false));
+    if (r.error().isCanceled()) {
+        secCtx->cancelPendingOperation();
+    }
+    secThread.wait();
+    r.mergeWith(secThread.mResult);
+
+    return std::make_tuple(r, std::vector<Key>(), std::vector<Key>(), QString(), Error());
+}
+
 Error QGpgMEListAllKeysJob::start(bool mergeKeys)
 {
     run(std::bind(&list_keys, std::placeholders::_1, mergeKeys));
     return Error();
 }
 
+Error QGpgMEListAllKeysJob::startStreaming(bool mergeKeys, int batchSize)
+{
+    run(std::bind(&stream_all_keys, std::placeholders::_1, this, mergeKeys, batchSize));
+    return Error();
+}
+
 KeyListResult QGpgMEListAllKeysJob::exec(std::vector<Key> &pub, std::vector<Key> &sec, bool mergeKeys)
 {
     const result_type r = list_keys(context(), mergeKeys);
@@ -157,6 +368,16 @@ void QGpgMEListAllKeysJob::resultHook(const result_type &tuple)
     mResult = std::get<0>(tuple);
 }
 
+bool QGpgMEListAllKeysJob::event(QEvent *e)
+{
+    if (e->type() == KeyBatchEvent::eventType()) {
+        const KeyBatchEvent *const batch = static_cast<KeyBatchEvent *>(e);
+        Q_EMIT nextKeys(batch->mPub, batch->mSec);
+        return true;
+    }
+    return mixin_type::event(e);
+}
+
 #if 0
 void QGpgMEListAllKeysJob::showErrorDialog(QWidget *parent, const QString &caption) const
 {
@@ -72,12 +72,18 @@ public:
     /* from ListAllKeysJob */
     GpgME::Error start(bool mergeKeys) Q_DECL_OVERRIDE;
 
+    /* from ListAllKeysJob */
+    GpgME::Error startStreaming(bool mergeKeys, int batchSize) Q_DECL_OVERRIDE;
+
     /* from ListAllKeysJob */
     GpgME::KeyListResult exec(std::vector<GpgME::Key> &pub, std::vector<GpgME::Key> &sec, bool mergeKeys) Q_DECL_OVERRIDE;
 
     /* from ThreadedJobMixin */
     void resultHook(const result_type &result) Q_DECL_OVERRIDE;
 
+    /* from QObject */
+    bool event(QEvent *e) Q_DECL_OVERRIDE;
+
 private:
     GpgME::KeyListResult mResult;
 };
@@ -39,6 +39,7 @@
 #include "threadedjobmixin.h"
 
 #include "dataprovider.h"
+#include "protocol.h"
 
 #include "data.h"
 
@@ -142,6 +143,32 @@ QString _detail::audit_log_as_html(Context *ctx, GpgME::Error &err)
     return QStringLiteral("Unsupported protocol for Audit Log");
 }
 
+QThreadPool *_detail::thread_pool_for_protocol(GpgME::Protocol proto)
+{
+    switch (proto) {
+    case OpenPGP: return QGpgME::openpgp()->threadPool();
+    case CMS:     return QGpgME::smime()->threadPool();
+    default:      return nullptr;
+    }
+}
+
+bool _detail::take_from_thread_pool(QThreadPool *pool, QRunnable *runnable)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 9, 0)
+    return pool->tryTake(runnable);
+#else
+    Q_UNUSED(pool);
+    Q_UNUSED(runnable);
+    return false;
+#endif
+}
+
+QEvent::Type _detail::job_finished_event_type()
+{
+    static const QEvent::Type type = static_cast<QEvent::Type>(QEvent::registerEventType());
+    return type;
+}
+
 static QList<QByteArray> from_sl(const QStringList &sl)
 {
     QList<QByteArray> result;
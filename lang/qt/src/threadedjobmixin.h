@@ -35,9 +35,13 @@
 #ifndef __QGPGME_THREADEDJOBMIXING_H__
 #define __QGPGME_THREADEDJOBMIXING_H__
 
+#include <QCoreApplication>
+#include <QEvent>
 #include <QMutex>
 #include <QMutexLocker>
+#include <QRunnable>
 #include <QThread>
+#include <QThreadPool>
 #include <QString>
 #include <QIODevice>
 
@@ -53,6 +57,7 @@
 
 #include <cassert>
 #include <functional>
+#include <type_traits>
 
 namespace QGpgME
 {
@@ -61,6 +66,31 @@ namespace _detail
 
 QString audit_log_as_html(GpgME::Context *ctx, GpgME::Error &err);
 
+/* Return the thread pool set for the protocol PROTO or nullptr.  */
+QThreadPool *thread_pool_for_protocol(GpgME::Protocol proto);
+
+/* Remove RUNNABLE from the queue of POOL.  Returns true if RUNNABLE
+ * was removed, which is never the case with Qt before 5.9.  */
+bool take_from_thread_pool(QThreadPool *pool, QRunnable *runnable);
+
+/* The type of the event posted to a job when its function has been
+ * run on a thread pool.  */
+QEvent::Type job_finished_event_type();
+
+/* Return the value reported as first result of a canceled job.  */
+template <typename T>
+typename std::enable_if<std::is_constructible<T, GpgME::Error>::value, T>::type
+canceled_value()
+{
+    return T(GpgME::Error::fromCode(GPG_ERR_CANCELED));
+}
+template <typename T>
+typename std::enable_if<!std::is_constructible<T, GpgME::Error>::value, T>::type
+canceled_value()
+{
+    return T();
+}
+
 class PatternConverter
 {
     const QList<QByteArray> m_list;
@@ -109,17 +139,42 @@ public:
         return m_result;
     }
 
-private:
-    void run() Q_DECL_OVERRIDE {
+    void setResult(const T_result &result)
+    {
+        const QMutexLocker locker(&m_mutex);
+        m_result = result;
+    }
+
+    // Run the function in the calling thread.  This is used instead
+    // of start() if the job is run on a thread pool.
+    void runFunction()
+    {
         const QMutexLocker locker(&m_mutex);
         m_result = m_function();
     }
+
+private:
+    void run() Q_DECL_OVERRIDE {
+        runFunction();
+    }
 private:
     mutable QMutex m_mutex;
     std::function<T_result()> m_function;
     T_result m_result;
 };
 
+class FunctionRunnable : public QRunnable
+{
+public:
+    explicit FunctionRunnable(const std::function<void()> &function) : m_function(function) {}
+
+    void run() Q_DECL_OVERRIDE {
+        m_function();
+    }
+private:
+    const std::function<void()> m_function;
+};
+
 template <typename T_base, typename T_result = std::tuple<GpgME::Error, QString, GpgME::Error> >
 class ThreadedJobMixin : public T_base, public GpgME::ProgressProvider
 {
@@ -148,7 +203,8 @@ protected:
                   "Last result type not a GpgME::Error");
 
     explicit ThreadedJobMixin(GpgME::Context *ctx)
-        : T_base(nullptr), m_ctx(ctx), m_thread(), m_auditLog(), m_auditLogError()
+        : T_base(nullptr), m_ctx(ctx), m_thread(), m_pool(nullptr), m_runnable(nullptr),
+          m_auditLog(), m_auditLogError()
     {
     }
 
@@ -164,42 +220,56 @@ protected:
     ~ThreadedJobMixin()
     {
         QGpgME::g_context_map.remove(this);
+        if (m_pool) {
+            const QMutexLocker locker(&m_runnableMutex);
+            if (m_runnable && _detail::take_from_thread_pool(m_pool, m_runnable)) {
+                delete m_runnable;
+            }
+        }
     }
 
     template <typename T_binder>
     void run(const T_binder &func)
     {
+        m_pool = _detail::thread_pool_for_protocol(m_ctx->protocol());
         m_thread.setFunction(std::bind(func, this->context()));
-        m_thread.start();
+        startFunction();
     }
     template <typename T_binder>
     void run(const T_binder &func, const std::shared_ptr<QIODevice> &io)
     {
+        m_pool = _detail::thread_pool_for_protocol(m_ctx->protocol());
+        // On a thread pool the thread is not known before the function
+        // runs.  Detach the device from any thread, so that the thread
+        // running the function can take it.
+        QThread *const ioThread = m_pool ? nullptr : &m_thread;
         if (io) {
-            io->moveToThread(&m_thread);
+            io->moveToThread(ioThread);
         }
         // the arguments passed here to the functor are stored in a QThread, and are not
         // necessarily destroyed (living outside the UI thread) at the time the result signal
         // is emitted and the signal receiver wants to clean up IO devices.
         // To avoid such races, we pass std::weak_ptr's to the functor.
         m_thread.setFunction(std::bind(func, this->context(), this->thread(), std::weak_ptr<QIODevice>(io)));
-        m_thread.start();
+        startFunction(io);
     }
     template <typename T_binder>
     void run(const T_binder &func, const std::shared_ptr<QIODevice> &io1, const std::shared_ptr<QIODevice> &io2)
     {
+        m_pool = _detail::thread_pool_for_protocol(m_ctx->protocol());
+        QThread *const ioThread = m_pool ? nullptr : &m_thread;
         if (io1) {
-            io1->moveToThread(&m_thread);
+            io1->moveToThread(ioThread);
         }
         if (io2) {
-            io2->moveToThread(&m_thread);
+            io2->moveToThread(ioThread);
         }
         // the arguments passed here to the functor are stored in a QThread, and are not
         // necessarily destroyed (living outside the UI thread) at the time the result signal
         // is emitted and the signal receiver wants to clean up IO devices.
         // To avoid such races, we pass std::weak_ptr's to the functor.
         m_thread.setFunction(std::bind(func, this->context(), this->thread(), std::weak_ptr<QIODevice>(io1), std::weak_ptr<QIODevice>(io2)));
-        m_thread.start();
+        startFunction(io1, io2);
     }
     GpgME::Context *context() const
     {
@@ -219,6 +289,21 @@ protected:
         this->deleteLater();
     }
     void slotCancel() Q_DECL_OVERRIDE {
+        if (m_pool)
+        {
+            // A job still waiting in the queue of the pool is removed
+            // and finishes right away.
+            const QMutexLocker locker(&m_runnableMutex);
+            if (m_runnable && _detail::take_from_thread_pool(m_pool, m_runnable)) {
+                delete m_runnable;
+                m_runnable = nullptr;
+                T_result r;
+                std::get<0>(r) = _detail::canceled_value<typename std::tuple_element<0, T_result>::type>();
+                m_thread.setResult(r);
+                QCoreApplication::postEvent(this, new QEvent(_detail::job_finished_event_type()));
+                return;
+            }
+        }
         if (m_ctx)
         {
             m_ctx->cancelPendingOperation();
@@ -244,7 +329,44 @@ protected:
         Q_ARG(int, current),
         Q_ARG(int, total));
     }
+    bool event(QEvent *e) Q_DECL_OVERRIDE
+    {
+        if (e->type() == _detail::job_finished_event_type()) {
+            slotFinished();
+            return true;
+        }
+        return T_base::event(e);
+    }
 private:
+    // Run the function set for m_thread on the thread pool of the
+    // protocol, ordered by the priority of the job, or on a thread of
+    // its own if there is no pool.  IO1 and IO2 are the devices passed
+    // to the function.
+    void startFunction(const std::shared_ptr<QIODevice> &io1 = std::shared_ptr<QIODevice>(),
+                       const std::shared_ptr<QIODevice> &io2 = std::shared_ptr<QIODevice>())
+    {
+        if (!m_pool) {
+            m_thread.start();
+            return;
+        }
+        const std::weak_ptr<QIODevice> wio1(io1), wio2(io2);
+        const QMutexLocker locker(&m_runnableMutex);
+        m_runnable = new FunctionRunnable([this, wio1, wio2]() {
+            {
+                const QMutexLocker locker(&m_runnableMutex);
+                m_runnable = nullptr;
+            }
+            for (const auto &wio : {wio1, wio2}) {
+                if (const auto io = wio.lock()) {
+                    io->moveToThread(QThread::currentThread());
+                }
+            }
+            m_thread.runFunction();
+            QCoreApplication::postEvent(this, new QEvent(_detail::job_finished_event_type()));
+        });
+        m_pool->start(m_runnable, Job::priority(this));
+    }
+
     template <typename T1, typename T2>
     void doEmitResult(const std::tuple<T1, T2> &tuple)
     {
@@ -272,6 +394,10 @@ private:
 private:
     std::shared_ptr<GpgME::Context> m_ctx;
     Thread<T_result> m_thread;
+    QThreadPool *m_pool;
+    // The runnable queued on m_pool until it is started.
+    QMutex m_runnableMutex;
+    QRunnable *m_runnable;
     QString m_auditLog;
     GpgME::Error m_auditLogError;
 };
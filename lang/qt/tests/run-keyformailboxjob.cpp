@@ -35,6 +35,7 @@
 #endif
 
 #include "keyformailboxjob.h"
+#include "keysformailboxesjob.h"
 #include "keylistjob.h"
 #include "protocol.h"
 
@@ -49,6 +50,21 @@ int main(int argc, char **argv)
     QString mailbox;
     if (argc == 2) {
         mailbox = QString::fromLocal8Bit(argv[1]);
+    } else if (argc > 2) {
+        // Look up all mailboxes at once.
+        QStringList mailboxes;
+        for (int i = 1; i < argc; i++) {
+            mailboxes << QString::fromLocal8Bit(argv[i]);
+        }
+        auto job = QGpgME::openpgp()->keysForMailboxesJob();
+        std::vector<GpgME::Key> keys;
+        std::vector<GpgME::UserID> uids;
+        job->exec(mailboxes, true, keys, uids);
+        for (int i = 0; i < mailboxes.size(); i++) {
+            qDebug() << mailboxes.at(i) << "UID Name: " << uids[i].name() << " Mail: " << uids[i].email();
+            qDebug() << "Key fpr: " << keys[i].primaryFingerprint();
+        }
+        return 0;
     }
 
     auto job = QGpgME::openpgp()->keyForMailboxJob();
@@ -38,12 +38,18 @@
 #include <QTest>
 #include <QSignalSpy>
 #include <QMap>
+#include <QSet>
+#include <QThreadPool>
 #include "keylistjob.h"
+#include "listallkeysjob.h"
+#include "hierarchicalkeylistjob.h"
 #include "qgpgmebackend.h"
 #include "keylistresult.h"
 
 #include "context.h"
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
 
 #include "t-support.h"
@@ -76,6 +82,65 @@ private Q_SLOTS:
         QVERIFY (keys[0].subkeys()[1].publicKeyAlgorithm() == Subkey::AlgoELG_E);
     }
 
+    void testKeyItemRanges()
+    {
+        KeyListJob *job = openpgp()->keyListJob(false, false, false);
+        std::vector<GpgME::Key> keys;
+        GpgME::KeyListResult result = job->exec(QStringList() << QStringLiteral("alfa@example.net"),
+                                                false, keys);
+        delete job;
+        QVERIFY (!result.error());
+        QVERIFY (keys.size() == 1);
+
+        const auto uids = keys[0].userIDs();
+        unsigned int n = 0;
+        for (const UserID &uid : keys[0].userIDRange()) {
+            QVERIFY (n < uids.size());
+            QVERIFY (!strcmp(uid.id(), uids[n++].id()));
+        }
+        QVERIFY (n == uids.size());
+
+        const auto subkeys = keys[0].subkeys();
+        n = 0;
+        for (const Subkey &subkey : keys[0].subkeyRange()) {
+            QVERIFY (n < subkeys.size());
+            QVERIFY (!strcmp(subkey.fingerprint(), subkeys[n++].fingerprint()));
+        }
+        QVERIFY (n == subkeys.size());
+
+        // Items are returned by value, so they stay valid when the
+        // iterator is incremented or destroyed.
+        const UserID &firstUid = *keys[0].userIDRange().begin();
+        QVERIFY (!strcmp(firstUid.id(), uids[0].id()));
+
+        const auto subkeyRange = keys[0].subkeyRange();
+        auto it = subkeyRange.begin();
+        const Subkey &primary = *it;
+        const auto saved = it++;
+        QVERIFY (primary.publicKeyAlgorithm() == Subkey::AlgoDSA);
+        QVERIFY (saved->publicKeyAlgorithm() == Subkey::AlgoDSA);
+        QVERIFY (it->publicKeyAlgorithm() == Subkey::AlgoELG_E);
+        QVERIFY (++it == subkeyRange.end());
+
+        const auto minAlgo = std::min_element(subkeyRange.begin(), subkeyRange.end(),
+                                              [](const Subkey &a, const Subkey &b) {
+                                                  return a.publicKeyAlgorithm() < b.publicKeyAlgorithm();
+                                              });
+        QVERIFY (minAlgo != subkeyRange.end());
+        const Subkey &encSubkey = *minAlgo;
+        QVERIFY (std::distance(subkeyRange.begin(), minAlgo) == 1);
+        QVERIFY (encSubkey.publicKeyAlgorithm() == Subkey::AlgoELG_E);
+
+        // The range keeps the key alive.
+        const auto range = keys[0].subkeyRange();
+        keys.clear();
+        QVERIFY (!range.empty());
+        QVERIFY (range.begin()->publicKeyAlgorithm() == Subkey::AlgoDSA);
+
+        QVERIFY (Key().userIDRange().empty());
+        QVERIFY (UserID().signatureRange().begin() == UserID().signatureRange().end());
+    }
+
     // This test can help with valgrind to check for memleaks when handling
     // keys
     void testGetKey()
@@ -138,6 +203,123 @@ private Q_SLOTS:
         QSignalSpy spy (this, SIGNAL(asyncDone()));
         QVERIFY(spy.wait(QSIGNALSPY_TIMEOUT));
     }
+
+    void testListAllKeysStreaming()
+    {
+        std::vector<Key> pub, sec;
+        auto syncJob = openpgp()->listAllKeysJob();
+        QVERIFY(!syncJob->exec(pub, sec, true).error());
+        QVERIFY(!pub.empty());
+        QSet<QByteArray> expected, expectedSecret;
+        for (const auto &key: pub) {
+            expected << QByteArray(key.primaryFingerprint());
+            if (key.hasSecret()) {
+                expectedSecret << QByteArray(key.primaryFingerprint());
+            }
+        }
+
+        QSet<QByteArray> streamed, streamedSecret;
+        size_t nSec = 0;
+        auto job = openpgp()->listAllKeysJob();
+        connect(job, &ListAllKeysJob::nextKeys, job, [&streamed, &streamedSecret, &nSec](const std::vector<Key> &keys, const std::vector<Key> &secKeys)
+        {
+            QVERIFY(keys.size() <= 2 && secKeys.size() <= 2);
+            for (const auto &key: keys) {
+                QVERIFY(!streamed.contains(QByteArray(key.primaryFingerprint())));
+                streamed << QByteArray(key.primaryFingerprint());
+                if (key.hasSecret()) {
+                    streamedSecret << QByteArray(key.primaryFingerprint());
+                }
+            }
+            nSec += secKeys.size();
+        });
+        connect(job, &ListAllKeysJob::result, job, [this](KeyListResult result, std::vector<Key> keys, std::vector<Key> secKeys, QString, Error)
+        {
+            QVERIFY(!result.error());
+            QVERIFY(keys.empty() && secKeys.empty());
+            Q_EMIT asyncDone();
+        });
+        job->startStreaming(true, 2);
+        QSignalSpy spy (this, SIGNAL(asyncDone()));
+        QVERIFY(spy.wait(QSIGNALSPY_TIMEOUT));
+        QVERIFY(streamed == expected);
+        QVERIFY(streamedSecret == expectedSecret);
+        QVERIFY(nSec == sec.size());
+    }
+
+    void testHierarchicalKeyList()
+    {
+        // OpenPGP keys have no issuers, so there is only one level,
+        // but with two jobs both of them list alfa's key, which must
+        // be emitted only once.
+        auto *job = new HierarchicalKeyListJob(openpgp());
+        job->setMaxConcurrentJobs(2);
+        QStringList fprs;
+        connect(job, &KeyListJob::nextKey, job, [&fprs](const Key &key)
+        {
+            fprs << QString::fromLatin1(key.primaryFingerprint());
+        });
+        connect(job, &KeyListJob::result, job, [this](KeyListResult result, std::vector<Key>, QString, Error)
+        {
+            QVERIFY(!result.error());
+            Q_EMIT asyncDone();
+        });
+        QVERIFY(!job->start(QStringList() << QStringLiteral("alfa@example.net")
+                                          << QStringLiteral("A0FF4590BB6122EDEF6E3C542D727CC768697734")
+                                          << QStringLiteral("bravo@example.net")));
+        QSignalSpy spy (this, SIGNAL(asyncDone()));
+        QVERIFY(spy.wait(QSIGNALSPY_TIMEOUT));
+        QVERIFY(fprs.size() == 2);
+        QVERIFY(fprs.contains(QStringLiteral("A0FF4590BB6122EDEF6E3C542D727CC768697734")));
+        QVERIFY(fprs.contains(QStringLiteral("D695676BDCEDCC2CDD6152BCFE180B1DA9E3B0B2")));
+
+        // A full listing is refused.
+        job = new HierarchicalKeyListJob(openpgp());
+        QVERIFY(job->start(QStringList()).code() == GPG_ERR_UNSUPPORTED_OPERATION);
+    }
+
+    void testKeyListAsyncThreadPool()
+    {
+        // A single thread runs one job while the others are queued.
+        QThreadPool pool;
+        pool.setMaxThreadCount(1);
+        openpgp()->setThreadPool(&pool);
+
+        const int nJobs = 8;
+        int nResults = 0;
+        int nCanceled = 0;
+        QList<KeyListJob *> jobs;
+        for (int i = 0; i < nJobs; i++) {
+            KeyListJob *job = openpgp()->keyListJob();
+            connect(job, &KeyListJob::result, job, [this, &nResults, &nCanceled, nJobs](KeyListResult result, std::vector<Key> keys, QString, Error)
+            {
+                if (result.error().isCanceled()) {
+                    nCanceled++;
+                } else {
+                    QVERIFY(keys.size() == 1);
+                }
+                if (++nResults == nJobs) {
+                    Q_EMIT asyncDone();
+                }
+            });
+            jobs.append(job);
+        }
+        // The first job starts right away, the last one is next.
+        Job::setPriority(jobs.last(), 1);
+        QVERIFY(Job::priority(jobs.last()) == 1);
+        Q_FOREACH (KeyListJob *job, jobs) {
+            job->start(QStringList() << "alfa@example.net");
+        }
+        jobs.at(nJobs - 2)->slotCancel();
+
+        QSignalSpy spy (this, SIGNAL(asyncDone()));
+        QVERIFY(spy.wait(QSIGNALSPY_TIMEOUT));
+        QVERIFY(nResults == nJobs);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 9, 0)
+        QVERIFY(nCanceled == 1);
+#endif
+        openpgp()->setThreadPool(nullptr);
+    }
 };
 
 QTEST_MAIN(KeyListTest)
@@ -84,6 +84,33 @@ private Q_SLOTS:
         QVERIFY(dn.prettyDN() == QStringLiteral("DC=North America,DC=Fabrikam,DC=COM,OU=Test,CN=Before\rAfter"));
     }
 
+    void testDNCache()
+    {
+        const char *raw = "2.5.4.4=Smith,CN=Foo\\, Bar,O=Acme,1.2.840.113549.1.9.1=#666F6F40626172";
+        DN dn(raw);
+        QVERIFY(dn.dn() == QStringLiteral("SN=Smith,CN=Foo\\, Bar,O=Acme,EMAIL=foo@bar"));
+        QVERIFY(dn.prettyDN() == QStringLiteral("CN=Foo\\, Bar,SN=Smith,EMAIL=foo@bar,O=Acme"));
+
+        // a second instance is served from the cache
+        DN dn2(QString::fromUtf8(raw));
+        QVERIFY(dn2.dn() == dn.dn());
+        QVERIFY(dn2.prettyDN() == dn.prettyDN());
+
+        // the pretty form follows the order of each instance
+        dn2.setAttributeOrder(QStringList() << QStringLiteral("O") << QStringLiteral("CN"));
+        QVERIFY(dn2.prettyDN() == QStringLiteral("O=Acme,CN=Foo\\, Bar"));
+        QVERIFY(DN(raw).prettyDN() == dn.prettyDN());
+
+        // modifications are not cached
+        DN dn3(raw);
+        dn3.append(DN::Attribute(QStringLiteral("C"), QStringLiteral("DE")));
+        QVERIFY(dn3.prettyDN() == QStringLiteral("CN=Foo\\, Bar,SN=Smith,EMAIL=foo@bar,O=Acme,C=DE"));
+        QVERIFY(DN(raw).prettyDN() == dn.prettyDN());
+
+        QVERIFY(DN("CN=#41424,O=x").dn().isEmpty());
+        QVERIFY(DN("CN=foo\\").dn().isEmpty());
+    }
+
     void testKeyFromFile()
     {
         if (GpgME::engineInfo(GpgME::GpgEngine).engineVersion() < "2.1.14") {
@@ -165,6 +165,16 @@ struct gpgme_context
   /* The optional trust-model override.  */
   char *trust_model;
 
+  /* The transcript file for the replay engine or NULL.  */
+  char *replay_file;
+
+  /* The pacing of the replay engine as given by the user and parsed
+   * into the latency in microseconds and the rate in bytes per
+   * second.  */
+  char *replay_pace;
+  unsigned long replay_latency;
+  unsigned long replay_rate;
+
   /* The operation data hooked into the context.  */
   ctx_op_data_t op_data;
 
@@ -184,6 +194,14 @@ struct gpgme_context
      operation.  */
   struct fd_table fdt;
   struct gpgme_io_cbs io_cbs;
+
+  /* The statistics of the current operation, the time the operation
+     started and the per-thread spawn counters at that time.  */
+  struct _gpgme_op_stats stats;
+  unsigned long long stats_start;
+  unsigned long stats_spawns;
+  unsigned long long stats_spawn_usec;
+  unsigned int stats_done : 1;
 };
 
 #endif	/* CONTEXT_H */
@@ -0,0 +1,346 @@
+/* ctx-pool.c - Pool of pre-configured contexts.
+ * Copyright (C) 2026 g10 Code GmbH
+ *
+ * This file is part of GPGME.
+ *
+ * GPGME is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * GPGME is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, see <https://gnu.org/licenses/>.
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+#include <stdlib.h>
+#include <string.h>
+
+#include "util.h"
+#include "context.h"
+#include "ops.h"
+#include "debug.h"
+
+
+/* A pool of contexts.  All contexts handed out by the pool are
+ * configured like TEMPL, which is a private context never given to
+ * the caller.  Returned contexts are kept in IDLE for reuse.  */
+struct gpgme_ctx_pool
+{
+  DECLARE_LOCK (lock);
+
+  /* The private context holding the configuration.  */
+  gpgme_ctx_t templ;
+
+  /* The number of idle contexts and the array with those contexts.
+   * The array has room for SIZE contexts.  */
+  unsigned int size;
+  unsigned int nidle;
+  gpgme_ctx_t *idle;
+};
+
+
+/* Make sure that *DST is a copy of SRC.  Nothing is allocated if the
+ * strings are already equal.  */
+static gpgme_error_t
+sync_string (char **dst, const char *src)
+{
+  if (*dst && src && !strcmp (*dst, src))
+    return 0;
+
+  free (*dst);
+  *dst = NULL;
+  if (src)
+    {
+      *dst = strdup (src);
+      if (!*dst)
+        return gpg_error_from_syserror ();
+    }
+  return 0;
+}
+
+
+/* Return true if the engine info lists A and B are equal.  */
+static int
+engine_info_equal (gpgme_engine_info_t a, gpgme_engine_info_t b)
+{
+  for (; a && b; a = a->next, b = b->next)
+    {
+      if (a->protocol != b->protocol
+          || strcmp (a->file_name, b->file_name)
+          || !a->home_dir != !b->home_dir
+          || (a->home_dir && strcmp (a->home_dir, b->home_dir)))
+        return 0;
+    }
+  return !a && !b;
+}
+
+
+/* Configure CTX like TEMPL and drop all per-operation state of CTX.
+ * This does not touch the engine process of CTX unless the protocol
+ * or the engine info differs.  */
+static gpgme_error_t
+reset_ctx (gpgme_ctx_t ctx, gpgme_ctx_t templ)
+{
+  gpgme_error_t err;
+
+  _gpgme_release_result (ctx);
+  _gpgme_signers_clear (ctx);
+  _gpgme_sig_notation_clear (ctx);
+  free (ctx->sender);
+  ctx->sender = NULL;
+  free (ctx->override_session_key);
+  ctx->override_session_key = NULL;
+
+  if (!engine_info_equal (ctx->engine_info, templ->engine_info))
+    {
+      gpgme_engine_info_t info;
+
+      err = _gpgme_engine_info_dup (&info, templ->engine_info);
+      if (err)
+        return err;
+      _gpgme_engine_release (ctx->engine);
+      ctx->engine = NULL;
+      _gpgme_engine_info_release (ctx->engine_info);
+      ctx->engine_info = info;
+    }
+
+  if (!ctx->replay_file != !templ->replay_file
+      || (ctx->replay_file && strcmp (ctx->replay_file, templ->replay_file)))
+    {
+      _gpgme_engine_release (ctx->engine);
+      ctx->engine = NULL;
+      err = sync_string (&ctx->replay_file, templ->replay_file);
+      if (err)
+        return err;
+    }
+
+  if (ctx->protocol != templ->protocol)
+    {
+      _gpgme_engine_release (ctx->engine);
+      ctx->engine = NULL;
+      ctx->protocol = templ->protocol;
+    }
+
+  ctx->canceled = 0;
+  ctx->sub_protocol = templ->sub_protocol;
+  ctx->use_armor = templ->use_armor;
+  ctx->use_textmode = templ->use_textmode;
+  ctx->offline = templ->offline;
+  ctx->full_status = templ->full_status;
+  ctx->raw_description = templ->raw_description;
+  ctx->export_session_keys = templ->export_session_keys;
+  ctx->redraw_suggested = 0;
+  ctx->auto_key_retrieve = templ->auto_key_retrieve;
+  ctx->no_symkey_cache = templ->no_symkey_cache;
+  ctx->ignore_mdc_error = templ->ignore_mdc_error;
+  ctx->keylist_mode = templ->keylist_mode;
+  ctx->pinentry_mode = templ->pinentry_mode;
+  ctx->include_certs = templ->include_certs;
+  ctx->passphrase_cb = templ->passphrase_cb;
+  ctx->passphrase_cb_value = templ->passphrase_cb_value;
+  ctx->progress_cb = templ->progress_cb;
+  ctx->progress_cb_value = templ->progress_cb_value;
+  ctx->status_cb = templ->status_cb;
+  ctx->status_cb_value = templ->status_cb_value;
+  ctx->io_cbs = templ->io_cbs;
+  ctx->replay_latency = templ->replay_latency;
+  ctx->replay_rate = templ->replay_rate;
+
+  err = sync_string (&ctx->request_origin, templ->request_origin);
+  if (!err)
+    err = sync_string (&ctx->auto_key_locate, templ->auto_key_locate);
+  if (!err)
+    err = sync_string (&ctx->trust_model, templ->trust_model);
+  if (!err)
+    err = sync_string (&ctx->lc_ctype, templ->lc_ctype);
+  if (!err)
+    err = sync_string (&ctx->lc_messages, templ->lc_messages);
+  if (!err)
+    err = sync_string (&ctx->replay_pace, templ->replay_pace);
+
+  return err;
+}
+
+
+/* Create a new context configured like TEMPL.  Unlike gpgme_new this
+ * copies the engine info from TEMPL and thus does not need to access
+ * the global engine info.  */
+static gpgme_error_t
+new_pooled_ctx (gpgme_ctx_t templ, gpgme_ctx_t *r_ctx)
+{
+  gpgme_error_t err;
+  gpgme_ctx_t ctx;
+
+  ctx = calloc (1, sizeof *ctx);
+  if (!ctx)
+    return gpg_error_from_syserror ();
+
+  INIT_LOCK (ctx->lock);
+  _gpgme_fd_table_init (&ctx->fdt);
+  ctx->protocol = templ->protocol;
+
+  err = reset_ctx (ctx, templ);
+  if (err)
+    {
+      gpgme_release (ctx);
+      return err;
+    }
+
+  *r_ctx = ctx;
+  return 0;
+}
+
+
+/* Create a new pool of contexts configured like TEMPL and return it
+ * at R_POOL.  SIZE contexts are created right away and up to SIZE
+ * returned contexts are kept for reuse.  TEMPL may be released after
+ * this call.  */
+gpgme_error_t
+gpgme_ctx_pool_new (gpgme_ctx_pool_t *r_pool, gpgme_ctx_t templ,
+                    unsigned int size)
+{
+  gpgme_error_t err;
+  gpgme_ctx_pool_t pool;
+
+  TRACE_BEG (DEBUG_CTX, "gpgme_ctx_pool_new", templ, "size=%u", size);
+
+  if (_gpgme_selftest)
+    return TRACE_ERR (_gpgme_selftest);
+
+  if (!r_pool || !templ)
+    return TRACE_ERR (gpg_error (GPG_ERR_INV_VALUE));
+  *r_pool = NULL;
+
+  pool = calloc (1, sizeof *pool);
+  if (!pool)
+    return TRACE_ERR (gpg_error_from_syserror ());
+  INIT_LOCK (pool->lock);
+
+  if (size)
+    {
+      pool->idle = calloc (size, sizeof *pool->idle);
+      if (!pool->idle)
+        {
+          err = gpg_error_from_syserror ();
+          goto leave;
+        }
+    }
+  pool->size = size;
+
+  err = new_pooled_ctx (templ, &pool->templ);
+  if (err)
+    goto leave;
+
+  while (pool->nidle < pool->size)
+    {
+      err = new_pooled_ctx (pool->templ, &pool->idle[pool->nidle]);
+      if (err)
+        goto leave;
+      pool->nidle++;
+    }
+
+ leave:
+  if (err)
+    {
+      gpgme_ctx_pool_release (pool);
+      return TRACE_ERR (err);
+    }
+
+  *r_pool = pool;
+  TRACE_SUC ("pool=%p", pool);
+  return 0;
+}
+
+
+/* Release POOL and all idle contexts.  Contexts which are still
+ * checked out are not affected and must be released by the caller
+ * using gpgme_release.  */
+void
+gpgme_ctx_pool_release (gpgme_ctx_pool_t pool)
+{
+  TRACE (DEBUG_CTX, "gpgme_ctx_pool_release", pool, "");
+
+  if (!pool)
+    return;
+
+  while (pool->nidle)
+    gpgme_release (pool->idle[--pool->nidle]);
+  free (pool->idle);
+  gpgme_release (pool->templ);
+  DESTROY_LOCK (pool->lock);
+  free (pool);
+}
+
+
+/* Take a context from POOL and store it at R_CTX.  If no idle
+ * context is available a new one is created.  The context must be
+ * returned with gpgme_ctx_pool_put.  */
+gpgme_error_t
+gpgme_ctx_pool_get (gpgme_ctx_pool_t pool, gpgme_ctx_t *r_ctx)
+{
+  gpgme_error_t err;
+  gpgme_ctx_t ctx = NULL;
+
+  TRACE_BEG (DEBUG_CTX, "gpgme_ctx_pool_get", pool, "");
+
+  if (!pool || !r_ctx)
+    return TRACE_ERR (gpg_error (GPG_ERR_INV_VALUE));
+
+  LOCK (pool->lock);
+  if (pool->nidle)
+    ctx = pool->idle[--pool->nidle];
+  UNLOCK (pool->lock);
+
+  if (!ctx)
+    {
+      /* The template is never modified after the pool has been
+       * created and thus may be used without holding the lock.  */
+      err = new_pooled_ctx (pool->templ, &ctx);
+      if (err)
+        return TRACE_ERR (err);
+    }
+
+  *r_ctx = ctx;
+  TRACE_SUC ("ctx=%p", ctx);
+  return 0;
+}
+
+
+/* Return CTX, which must have been taken from POOL, to POOL.  The
+ * operation on CTX must have finished.  All results, signers and
+ * notations are released and the configuration is reset to that of
+ * the pool.  */
+void
+gpgme_ctx_pool_put (gpgme_ctx_pool_t pool, gpgme_ctx_t ctx)
+{
+  TRACE (DEBUG_CTX, "gpgme_ctx_pool_put", pool, "ctx=%p", ctx);
+
+  if (!pool || !ctx)
+    return;
+
+  if (reset_ctx (ctx, pool->templ))
+    {
+      gpgme_release (ctx);
+      return;
+    }
+
+  LOCK (pool->lock);
+  if (pool->nidle < pool->size)
+    {
+      pool->idle[pool->nidle++] = ctx;
+      ctx = NULL;
+    }
+  UNLOCK (pool->lock);
+
+  /* The pool is full.  */
+  gpgme_release (ctx);
+}
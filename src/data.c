@@ -584,6 +584,7 @@ _gpgme_data_inbound_handler (void *opaque, int fd)
       _gpgme_io_close (fd);
       return TRACE_ERR (0);
     }
+  data->stats->bytes_in += buflen;
 
   do
     {
@@ -636,6 +637,7 @@ _gpgme_data_outbound_handler (void *opaque, int fd)
 
   if (nwritten <= 0)
     return TRACE_ERR (gpg_error_from_syserror ());
+  data->stats->bytes_out += nwritten;
 
   if (nwritten < dh->pending_len)
     memmove (dh->pending, dh->pending + nwritten, dh->pending_len - nwritten);
@@ -40,6 +40,7 @@
 #  include <sys/stat.h>
 # endif
 # include <fcntl.h>
+# include <pthread.h>
 #endif
 #include <assert.h>
 
@@ -67,6 +68,9 @@ static FILE *errfp;
    any effect.  */
 static char *envvar_override;
 
+/* Same as ENVVAR_OVERRIDE but for GPGME_SPANS.  */
+static char *spans_envvar_override;
+
 
 #ifdef HAVE_TLS
 #define FRAME_NR
@@ -130,6 +134,239 @@ _gpgme_debug_set_debug_envvar (const char *value)
 }
 
 
+/* Likewise for the span trace.  */
+int
+_gpgme_debug_set_spans_envvar (const char *value)
+{
+  free (spans_envvar_override);
+  spans_envvar_override = strdup (value);
+  return !spans_envvar_override;
+}
+
+
+/*
+ * Span tracing.
+ *
+ * Span events are recorded in a per-thread buffer without taking a
+ * lock and written out when the buffer is full, when the thread
+ * exits, or at process exit.
+ * The output is one JSON object per line using the field names of
+ * the Trace Event Format, so that "jq -s ." turns it into a file
+ * which can be loaded by common trace viewers.
+ */
+
+#if defined(FRAME_NR) && defined(CLOCK_MONOTONIC) \
+    && !defined(HAVE_DOSISH_SYSTEM)
+# define USE_SPANS 1
+#endif
+
+/* Non-zero if span events shall be recorded.  */
+int _gpgme_spans_enabled;
+
+#ifdef USE_SPANS
+#define SPAN_BUFFER_SIZE 512
+
+struct span_event_s
+{
+  const char *name;
+  const void *tag;
+  unsigned long long ts;  /* Nanoseconds.  */
+  char phase;
+};
+
+struct span_buffer_s
+{
+  struct span_buffer_s *next;
+  unsigned long long tid;
+  /* Number of valid entries in EVENTS.  Only the owning thread
+   * appends to EVENTS.  */
+  unsigned int used;
+  struct span_event_s events[SPAN_BUFFER_SIZE];
+};
+
+/* The buffer of the current thread.  It is also stored under
+ * SPAN_BUFFER_KEY so that it is released when the thread exits.  */
+static __thread struct span_buffer_s *span_buffer;
+static pthread_key_t span_buffer_key;
+static pthread_once_t span_buffer_key_once = PTHREAD_ONCE_INIT;
+static int span_buffer_key_ok;
+
+/* List of all buffers and the output stream, both protected by
+ * SPANS_LOCK.  */
+static struct span_buffer_s *span_buffers;
+static FILE *spans_fp;
+DEFINE_STATIC_LOCK (spans_lock);
+
+
+/* Write out and empty BUFFER.  SPANS_LOCK must be held.  */
+static void
+spans_write (struct span_buffer_s *buffer)
+{
+  struct span_event_s *ev;
+  unsigned int i, n;
+  unsigned long pid = (unsigned long)getpid ();
+
+  n = buffer->used;
+  for (i = 0; i < n; i++)
+    {
+      ev = buffer->events + i;
+      fprintf (spans_fp,
+               "{\"name\":\"%s\",\"cat\":\"gpgme\",\"ph\":\"%c\","
+               "\"ts\":%llu.%03u,\"pid\":%lu,\"tid\":%llu",
+               ev->name, ev->phase,
+               ev->ts / 1000, (unsigned int)(ev->ts % 1000),
+               pid, buffer->tid);
+      if (ev->phase == 'b' || ev->phase == 'e')
+        fprintf (spans_fp, ",\"id\":\"%p\"", ev->tag);
+      else if (ev->tag)
+        fprintf (spans_fp, ",\"args\":{\"tag\":\"%p\"}", ev->tag);
+      if (ev->phase == 'i')
+        fputs (",\"s\":\"t\"", spans_fp);
+      fputs ("}\n", spans_fp);
+    }
+  buffer->used = 0;
+}
+
+
+/* Write out, unlink and release the buffer ARG of an exiting
+ * thread.  */
+static void
+span_buffer_release (void *arg)
+{
+  struct span_buffer_s *buffer = arg;
+  struct span_buffer_s **p;
+
+  LOCK (spans_lock);
+  spans_write (buffer);
+  for (p = &span_buffers; *p; p = &(*p)->next)
+    if (*p == buffer)
+      {
+        *p = buffer->next;
+        break;
+      }
+  UNLOCK (spans_lock);
+  span_buffer = NULL;
+  free (buffer);
+}
+
+
+static void
+span_buffer_key_init (void)
+{
+  span_buffer_key_ok = !pthread_key_create (&span_buffer_key,
+                                            span_buffer_release);
+}
+
+
+/* Write out the buffers of all threads.  This is called at process
+ * exit; other threads may still be running, so their latest events
+ * may be lost.  */
+static void
+spans_flush_all (void)
+{
+  struct span_buffer_s *buffer;
+
+  LOCK (spans_lock);
+  for (buffer = span_buffers; buffer; buffer = buffer->next)
+    spans_write (buffer);
+  fflush (spans_fp);
+  UNLOCK (spans_lock);
+}
+
+
+/* Open the span output file FNAME.  Called by debug_init with
+ * DEBUG_LOCK held.  */
+static void
+spans_init (const char *fname)
+{
+  FILE *fp;
+
+#ifndef HAVE_DOSISH_SYSTEM
+  if (getuid () != geteuid ()
+#if defined(HAVE_GETGID) && defined(HAVE_GETEGID)
+      || getgid () != getegid ()
+#endif
+      )
+    return;
+#endif
+  fp = fopen (fname, "a");
+  if (!fp)
+    return;
+  spans_fp = fp;
+  atexit (spans_flush_all);
+  _gpgme_spans_enabled = 1;
+}
+#endif /*USE_SPANS*/
+
+
+/* Record the span event PHASE for NAME, which must be a string
+ * literal.  PHASE is 'B' or 'E' for the begin or end of a span in the
+ * current thread, 'b' or 'e' for the begin or end of a span
+ * identified by TAG which may end in another thread, and 'i' for an
+ * instant event.  Use the TRACE_SPAN macros instead of calling this
+ * directly.  */
+void
+_gpgme_span_event (const char *name, int phase, const void *tag)
+{
+#ifdef USE_SPANS
+  struct span_buffer_s *buffer = span_buffer;
+  struct span_event_s *ev;
+  struct timespec tp;
+  int saved_errno = errno;
+
+  if (!buffer)
+    {
+      /* Without a way to release the buffer at thread exit, we
+       * would leak it with every thread.  */
+      pthread_once (&span_buffer_key_once, span_buffer_key_init);
+      if (!span_buffer_key_ok)
+        {
+          gpg_err_set_errno (saved_errno);
+          return;
+        }
+      buffer = calloc (1, sizeof *buffer);
+      if (!buffer)
+        {
+          gpg_err_set_errno (saved_errno);
+          return;
+        }
+      if (pthread_setspecific (span_buffer_key, buffer))
+        {
+          free (buffer);
+          gpg_err_set_errno (saved_errno);
+          return;
+        }
+      buffer->tid = (unsigned long long) ath_self ();
+      LOCK (spans_lock);
+      buffer->next = span_buffers;
+      span_buffers = buffer;
+      UNLOCK (spans_lock);
+      span_buffer = buffer;
+    }
+  else if (buffer->used == SPAN_BUFFER_SIZE)
+    {
+      LOCK (spans_lock);
+      spans_write (buffer);
+      UNLOCK (spans_lock);
+    }
+
+  clock_gettime (CLOCK_MONOTONIC, &tp);
+  ev = buffer->events + buffer->used;
+  ev->name = name;
+  ev->tag = tag;
+  ev->ts = (unsigned long long)tp.tv_sec * 1000000000 + tp.tv_nsec;
+  ev->phase = phase;
+  buffer->used++;
+  gpg_err_set_errno (saved_errno);
+#else
+  (void)name;
+  (void)phase;
+  (void)tag;
+#endif
+}
+
+
+
 static void
 debug_init (void)
 {
@@ -160,6 +397,24 @@ debug_init (void)
 
       initialized = 1;
       errfp = stderr;
+
+#ifdef USE_SPANS
+      {
+        char *spans;
+
+        if (spans_envvar_override)
+          {
+            spans = spans_envvar_override;
+            spans_envvar_override = NULL;
+          }
+        else if (_gpgme_getenv ("GPGME_SPANS", &spans))
+          spans = NULL;
+        if (spans && *spans)
+          spans_init (spans);
+        free (spans);
+      }
+#endif /*USE_SPANS*/
+
       if (e)
 	{
 	  debug_level = atoi (e);
@@ -312,7 +567,7 @@ _gpgme_debug (int level, int mode, const char *func, const char *tagname,
   if (need_lf || (format && *format && format[strlen (format) - 1] != '\n'))
     putc ('\n', errfp);
   UNLOCK (debug_lock);
-  fflush (errfp);
+  /* No need to flush: ERRFP is either unbuffered or line buffered.  */
 
   gpg_err_set_errno (saved_errno);
   return 0;
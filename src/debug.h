@@ -64,6 +64,9 @@ _gpgme_debug_srcname (const char *file)
 /* Initialization helper function; see debug.c.  */
 int _gpgme_debug_set_debug_envvar (const char *value);
 
+/* Initialization helper function; see debug.c.  */
+int _gpgme_debug_set_spans_envvar (const char *value);
+
 /* Called early to initialize the logging.  */
 void _gpgme_debug_subsystem_init (void);
 
@@ -218,6 +221,39 @@ _trace_syserr (int rc, int lvl, const char *func, int line)
 
 #define TRACE_ENABLED(hlp) (!!(hlp))
 
+/* Span tracing.  NAME must be a string literal.  The checks are
+   inlined so that disabled span tracing costs a load and a branch.  */
+extern int _gpgme_spans_enabled;
+void _gpgme_span_event (const char *name, int phase, const void *tag);
+
+/* Begin and end a span in the current thread.  */
+#define TRACE_SPAN_BEGIN(name, tag) do {                                \
+    if (_gpgme_spans_enabled)                                           \
+      _gpgme_span_event ((name), 'B', (const void *)(tag));             \
+  } while (0)
+#define TRACE_SPAN_END(name, tag) do {                                  \
+    if (_gpgme_spans_enabled)                                           \
+      _gpgme_span_event ((name), 'E', (const void *)(tag));             \
+  } while (0)
+
+/* Begin and end a span identified by TAG, which may end in a
+   different thread.  */
+#define TRACE_SPAN_ASYNC_BEGIN(name, tag) do {                          \
+    if (_gpgme_spans_enabled)                                           \
+      _gpgme_span_event ((name), 'b', (const void *)(tag));             \
+  } while (0)
+#define TRACE_SPAN_ASYNC_END(name, tag) do {                            \
+    if (_gpgme_spans_enabled)                                           \
+      _gpgme_span_event ((name), 'e', (const void *)(tag));             \
+  } while (0)
+
+/* Mark a point in time.  */
+#define TRACE_SPAN_MARK(name, tag) do {                                 \
+    if (_gpgme_spans_enabled)                                           \
+      _gpgme_span_event ((name), 'i', (const void *)(tag));             \
+  } while (0)
+
+
 /* And finally a simple macro to trace the location of an error code.
    This macro is independent of the other trace macros and may be used
    without any preconditions.  */
@@ -178,44 +178,60 @@ parse_output (char *line, int components)
 }
 
 
-/* Read the directory information from gpgconf.  This function expects
-   that DIRINFO_LOCK is held by the caller.  PGNAME is the name of the
-   gpgconf binary. If COMPONENTS is set, not the directories bit the
-   name of the componeNts are read. */
-static void
-read_gpgconf_dirs (const char *pgmname, int components)
+/* Start gpgconf to list the directories or, if COMPONENTS is set, the
+   components.  PGMNAME is the name of the gpgconf binary.  The pid
+   is stored at R_PID.  Returns the file descriptor to read the output
+   from or -1 on error.  */
+static int
+start_gpgconf (const char *pgmname, int components, pid_t *r_pid)
 {
-  char linebuf[1024] = {0};
-  int linelen = 0;
   char * argv[3];
   int rp[2];
   struct spawn_fd_item_s cfd[] = { {-1, 1 /* STDOUT_FILENO */, -1, 0},
 				   {-1, -1} };
   int status;
-  int nread;
-  char *mark = NULL;
 
   argv[0] = (char *)pgmname;
   argv[1] = (char*)(components? "--list-components" : "--list-dirs");
   argv[2] = NULL;
 
+  *r_pid = -1;
   if (_gpgme_io_pipe (rp, 1) < 0)
-    return;
+    return -1;
 
   cfd[0].fd = rp[1];
 
-  status = _gpgme_io_spawn (pgmname, argv, IOSPAWN_FLAG_DETACHED,
-                            cfd, NULL, NULL, NULL);
+  status = _gpgme_io_spawn (pgmname, argv,
+                            IOSPAWN_FLAG_DETACHED | IOSPAWN_FLAG_WAIT,
+                            cfd, NULL, NULL, r_pid);
   if (status < 0)
     {
       _gpgme_io_close (rp[0]);
       _gpgme_io_close (rp[1]);
-      return;
+      return -1;
     }
 
+  return rp[0];
+}
+
+
+/* Read and parse the output of gpgconf started by start_gpgconf from
+   FD, close FD and wait for the process PID.  This function expects
+   that DIRINFO_LOCK is held by the caller.  */
+static void
+read_gpgconf_output (int fd, pid_t pid, int components)
+{
+  char linebuf[1024] = {0};
+  int linelen = 0;
+  int nread;
+  char *mark = NULL;
+
+  if (fd == -1)
+    return;
+
   do
     {
-      nread = _gpgme_io_read (rp[0],
+      nread = _gpgme_io_read (fd,
                               linebuf + linelen,
                               sizeof linebuf - linelen - 1);
       if (nread > 0)
@@ -245,7 +261,26 @@ read_gpgconf_dirs (const char *pgmname, int components)
     }
   while (nread > 0 && linelen < sizeof linebuf - 1);
 
-  _gpgme_io_close (rp[0]);
+  _gpgme_io_close (fd);
+  _gpgme_io_spawn_wait (pid);
+}
+
+
+/* Read the directory information and the names of the components
+   from gpgconf.  This function expects that DIRINFO_LOCK is held by
+   the caller.  PGNAME is the name of the gpgconf binary.  Both
+   gpgconf processes are started before reading their output so that
+   they run concurrently.  */
+static void
+read_gpgconf_dirs (const char *pgmname)
+{
+  int dirs_fd, components_fd;
+  pid_t dirs_pid, components_pid;
+
+  dirs_fd = start_gpgconf (pgmname, 0, &dirs_pid);
+  components_fd = start_gpgconf (pgmname, 1, &components_pid);
+  read_gpgconf_output (dirs_fd, dirs_pid, 0);
+  read_gpgconf_output (components_fd, components_pid, 1);
 }
 
 
@@ -283,8 +318,7 @@ get_gpgconf_item (int what)
       else
         {
           dirinfo.gpg_one_mode = 0;
-          read_gpgconf_dirs (pgmname, 0);
-          read_gpgconf_dirs (pgmname, 1);
+          read_gpgconf_dirs (pgmname);
           dirinfo.gpgconf_name = pgmname;
         }
       /* Even if the reading of the directories failed (e.g. due to an
@@ -172,6 +172,7 @@ extern struct engine_ops _gpgme_engine_ops_g13;         /* Crypto VFS. */
 extern struct engine_ops _gpgme_engine_ops_uiserver;
 #endif
 extern struct engine_ops _gpgme_engine_ops_spawn;       /* Spawn engine. */
+extern struct engine_ops _gpgme_engine_ops_replay;      /* Replay engine. */
 
 
 /* Prototypes for extra functions in engine-gpgconf.c  */
@@ -183,6 +184,15 @@ gpgme_error_t _gpgme_conf_opt_change (gpgme_conf_opt_t opt, int reset,
 void _gpgme_conf_release (gpgme_conf_comp_t conf);
 gpgme_error_t _gpgme_conf_load (void *engine, gpgme_conf_comp_t *conf_p);
 
+/* The function used by _gpgme_conf_load_from to run gpgconf with the
+   arguments ARG1 and ARG2 and to pass each output line to CB.  */
+typedef gpgme_error_t (*_gpgme_conf_reader_t)
+     (void *engine, const char *arg1, char *arg2,
+      gpgme_error_t (*cb) (void *hook, char *line), void *hook);
+gpgme_error_t _gpgme_conf_load_from (_gpgme_conf_reader_t reader,
+                                     void *engine,
+                                     gpgme_conf_comp_t *conf_p);
+
 
 
 #endif /* ENGINE_BACKEND_H */
@@ -100,6 +100,7 @@ struct engine_gpg
     char *buffer;
     size_t readpos;
     int eof;
+    int seen_line;  /* At least one status line has been read.  */
     engine_status_handler_t fnc;
     void *fnc_value;
     gpgme_status_cb_t mon_cb;
@@ -155,6 +156,9 @@ struct engine_gpg
 
   /* Memory data containing diagnostics (--logger-fd) of gpg */
   gpgme_data_t diagnostics;
+
+  /* The pid of the gpg process or -1 if it has been waited for.  */
+  pid_t pid;
 };
 
 typedef struct engine_gpg *engine_gpg_t;
@@ -173,6 +177,26 @@ gpg_io_event (void *engine, gpgme_event_io_t type, void *type_data)
 }
 
 
+/* Wait for the gpg process if all pipes to it have been closed.  A
+ * parked command fd is not considered: gpg can't wait for it after it
+ * closed the status fd.  */
+static void
+wait_for_gpg (engine_gpg_t gpg)
+{
+  int i;
+
+  if (gpg->pid == -1 || gpg->status.fd[0] != -1 || gpg->colon.fd[0] != -1)
+    return;
+  if (gpg->fd_data_map)
+    for (i = 0; gpg->fd_data_map[i].data; i++)
+      if (gpg->fd_data_map[i].fd != -1)
+        return;
+
+  _gpgme_io_spawn_wait (gpg->pid);
+  gpg->pid = -1;
+}
+
+
 static void
 close_notify_handler (int fd, void *opaque)
 {
@@ -217,6 +241,8 @@ close_notify_handler (int fd, void *opaque)
             }
         }
     }
+
+  wait_for_gpg (gpg);
 }
 
 /* If FRONT is true, push at the front of the list.  Use this for
@@ -417,6 +443,9 @@ gpg_cancel (void *engine)
       gpg->fd_data_map = NULL;
     }
 
+  /* All pipes are closed now, thus gpg terminates soon.  */
+  wait_for_gpg (gpg);
+
   return 0;
 }
 
@@ -508,6 +537,7 @@ gpg_new (void **engine, const char *file_name, const char *home_dir,
   gpg->colon.fd[1] = -1;
   gpg->cmd.fd = -1;
   gpg->cmd.idx = -1;
+  gpg->pid = -1;
 
   /* Allocate the read buffer for the status pipe.  */
   gpg->status.bufsize = 1024;
@@ -1220,9 +1250,10 @@ add_io_cb (engine_gpg_t gpg, int fd, int dir, gpgme_io_cb_t handler, void *data,
    Of course we have to buffer the lines to cope with long lines
    e.g. with a large user ID.  Note: We can optimize this to only cope
    with status line code we know about and skip all other stuff
-   without buffering (i.e. without extending the buffer).  */
+   without buffering (i.e. without extending the buffer).  The number
+   of status lines is added to STATS.  */
 static gpgme_error_t
-read_status (engine_gpg_t gpg)
+read_status (engine_gpg_t gpg, gpgme_op_stats_t stats)
 {
   char *p;
   int nread;
@@ -1287,6 +1318,12 @@ read_status (engine_gpg_t gpg)
 		    *rest++ = 0;
 
 		  r = _gpgme_parse_status (buffer + 9);
+                  stats->status_lines++;
+                  if (!gpg->status.seen_line)
+                    {
+                      gpg->status.seen_line = 1;
+                      TRACE_SPAN_MARK ("first-status", gpg);
+                    }
                   if (gpg->status.mon_cb && r != GPGME_STATUS_PROGRESS)
                     {
                       /* Note that we call the monitor even if we do
@@ -1324,8 +1361,10 @@ read_status (engine_gpg_t gpg)
                         }
 		      else if (gpg->status.fnc)
 			{
+                          TRACE_SPAN_BEGIN ("status-handler", gpg);
 			  err = gpg->status.fnc (gpg->status.fnc_value,
 						 r, rest);
+                          TRACE_SPAN_END ("status-handler", gpg);
                           if (gpg_err_code (err) == GPG_ERR_FALSE)
                             err = 0; /* Drop special error code.  */
 			  if (err)
@@ -1366,7 +1405,7 @@ status_handler (void *opaque, int fd)
   int err;
 
   assert (fd == gpg->status.fd[0]);
-  err = read_status (gpg);
+  err = read_status (gpg, data->stats);
   if (err)
     return err;
   if (gpg->status.eof)
@@ -1569,7 +1608,8 @@ start (engine_gpg_t gpg)
   fd_list[n].dup_to = -1;
 
   status = _gpgme_io_spawn (pgmname, gpg->argv,
-                            (IOSPAWN_FLAG_DETACHED |IOSPAWN_FLAG_ALLOW_SET_FG),
+                            (IOSPAWN_FLAG_DETACHED |IOSPAWN_FLAG_ALLOW_SET_FG
+                             | IOSPAWN_FLAG_WAIT),
                             fd_list, NULL, NULL, &pid);
   {
     int saved_err = gpg_error_from_syserror ();
@@ -1577,6 +1617,7 @@ start (engine_gpg_t gpg)
     if (status == -1)
       return saved_err;
   }
+  gpg->pid = pid;
 
   /*_gpgme_register_term_handler ( closure, closure_value, pid );*/
 
@@ -29,12 +29,18 @@
 #ifdef HAVE_SYS_TYPES_H
 # include <sys/types.h>
 #endif
+#ifdef HAVE_SYS_STAT_H
+# include <sys/stat.h>
+#endif
 #include <assert.h>
 #ifdef HAVE_UNISTD_H
 # include <unistd.h>
 #endif
 #include <fcntl.h> /* FIXME */
 #include <errno.h>
+#ifdef HAVE_W32_SYSTEM
+# include <windows.h>
+#endif
 
 #include "gpgme.h"
 #include "util.h"
@@ -213,28 +219,20 @@ gpgconf_config_release (gpgme_conf_comp_t conf)
     }
 }
 
-/* Read from gpgconf and pass line after line to the hook function.
-   We put a limit of 64 k on the maximum size for a line.  This should
-   allow for quite a long "group" line, which is usually the longest
-   line (mine is currently ~3k).  */
+/* Run gpgconf with the arguments ARG1 and ARG2 and store the file
+   descriptor to read its output at R_FD and its pid at R_PID.  The
+   caller must close the file descriptor and then wait for the process
+   with _gpgme_io_spawn_wait.  */
 static gpgme_error_t
-gpgconf_read (void *engine, const char *arg1, char *arg2,
-	      gpgme_error_t (*cb) (void *hook, char *line),
-	      void *hook)
+gpgconf_spawn (engine_gpgconf_t gpgconf, const char *arg1, char *arg2,
+               int *r_fd, pid_t *r_pid)
 {
-  struct engine_gpgconf *gpgconf = engine;
-  gpgme_error_t err = 0;
-  char *linebuf;
-  size_t linebufsize;
-  int linelen;
   char *argv[6];
   int argc = 0;
   int rp[2];
   struct spawn_fd_item_s cfd[] = { {-1, 1 /* STDOUT_FILENO */, -1, 0},
 				   {-1, -1} };
   int status;
-  int nread;
-  char *mark = NULL;
 
   /* _gpgme_engine_new guarantees that this is not NULL.  */
   argv[argc++] = gpgconf->file_name;
@@ -256,7 +254,8 @@ gpgconf_read (void *engine, const char *arg1, char *arg2,
   cfd[0].fd = rp[1];
 
   status = _gpgme_io_spawn (gpgconf->file_name, argv,
-                            IOSPAWN_FLAG_DETACHED, cfd, NULL, NULL, NULL);
+                            IOSPAWN_FLAG_DETACHED | IOSPAWN_FLAG_WAIT,
+                            cfd, NULL, NULL, r_pid);
   if (status < 0)
     {
       _gpgme_io_close (rp[0]);
@@ -264,6 +263,33 @@ gpgconf_read (void *engine, const char *arg1, char *arg2,
       return gpg_error_from_syserror ();
     }
 
+  *r_fd = rp[0];
+  return 0;
+}
+
+
+/* Read from gpgconf and pass line after line to the hook function.
+   We put a limit of 64 k on the maximum size for a line.  This should
+   allow for quite a long "group" line, which is usually the longest
+   line (mine is currently ~3k).  */
+static gpgme_error_t
+gpgconf_read (void *engine, const char *arg1, char *arg2,
+	      gpgme_error_t (*cb) (void *hook, char *line),
+	      void *hook)
+{
+  gpgme_error_t err;
+  char *linebuf;
+  size_t linebufsize;
+  int linelen;
+  int fd;
+  pid_t pid;
+  int nread;
+  char *mark = NULL;
+
+  err = gpgconf_spawn (engine, arg1, arg2, &fd, &pid);
+  if (err)
+    return err;
+
   linebufsize = 1024; /* Usually enough for conf lines.  */
   linebuf = malloc (linebufsize);
   if (!linebuf)
@@ -273,7 +299,7 @@ gpgconf_read (void *engine, const char *arg1, char *arg2,
     }
   linelen = 0;
 
-  while ((nread = _gpgme_io_read (rp[0], linebuf + linelen,
+  while ((nread = _gpgme_io_read (fd, linebuf + linelen,
                                   linebufsize - linelen - 1)))
     {
       char *line;
@@ -337,7 +363,490 @@ gpgconf_read (void *engine, const char *arg1, char *arg2,
 
  leave:
   free (linebuf);
-  _gpgme_io_close (rp[0]);
+  _gpgme_io_close (fd);
+  _gpgme_io_spawn_wait (pid);
+  return err;
+}
+
+
+
+/* The identity of a file as used for the staleness check of the
+   configuration cache.  All fields are zero for a missing file.  */
+struct conf_file_id_s
+{
+  unsigned long long dev;
+  unsigned long long ino;
+  long long mtime;
+  long long size;
+};
+
+/* The number of files checked for staleness of a cache entry.  These
+   are the gpgconf binary, the component's configuration file and
+   common.conf in the home directory, and the component's global
+   configuration file and gpgconf.conf in the system configuration
+   directory.  */
+#define CONF_STAMP_FILES 5
+
+/* An entry of the configuration cache.  */
+struct conf_cache_item_s
+{
+  struct conf_cache_item_s *next;
+  struct conf_file_id_s stamp[CONF_STAMP_FILES];
+  /* The output of gpgconf with each line terminated by a Nul.  */
+  char *lines;
+  size_t lineslen;
+  /* The gpgconf file name, the home directory and the arguments, each
+     terminated by a linefeed.  */
+  char key[1];
+};
+
+/* Cache of the output of the gpgconf commands used to load the
+   configuration, so that a reload only needs to run gpgconf for
+   components whose configuration files have changed.  */
+static struct conf_cache_item_s *conf_cache;
+DEFINE_STATIC_LOCK (conf_cache_lock);
+
+
+/* Store the identity of the file NAME in directory DIR at ID.  DIR
+   may be NULL if NAME is a full file name.  */
+static void
+get_file_id (const char *dir, const char *name, struct conf_file_id_s *id)
+{
+  struct stat st;
+  char *fname = NULL;
+
+  memset (id, 0, sizeof *id);
+  if (dir)
+    {
+      fname = _gpgme_strconcat (dir, "/", name, NULL);
+      if (!fname)
+        return;
+      name = fname;
+    }
+  if (!stat (name, &st))
+    {
+      id->dev = st.st_dev;
+      id->ino = st.st_ino;
+      id->mtime = st.st_mtime;
+      id->size = st.st_size;
+    }
+  free (fname);
+}
+
+
+/* Store the stamp for the output of gpgconf for COMPONENT, which may
+   be NULL, at STAMP.  */
+static void
+conf_cache_stamp (engine_gpgconf_t gpgconf, const char *component,
+                  struct conf_file_id_s *stamp)
+{
+  const char *homedir, *sysconfdir;
+  char *name = NULL;
+
+  homedir = gpgconf->home_dir? gpgconf->home_dir
+                             : _gpgme_get_default_homedir ();
+  sysconfdir = gpgme_get_dirinfo ("sysconfdir");
+  if (component)
+    name = _gpgme_strconcat (component, ".conf", NULL);
+
+  memset (stamp, 0, CONF_STAMP_FILES * sizeof *stamp);
+  get_file_id (NULL, gpgconf->file_name, &stamp[0]);
+  if (homedir && name)
+    get_file_id (homedir, name, &stamp[1]);
+  if (homedir)
+    get_file_id (homedir, "common.conf", &stamp[2]);
+  if (sysconfdir && name)
+    get_file_id (sysconfdir, name, &stamp[3]);
+  if (sysconfdir)
+    get_file_id (sysconfdir, "gpgconf.conf", &stamp[4]);
+  free (name);
+}
+
+
+/* Return the cache key prefix for GPGCONF.  */
+static char *
+conf_cache_prefix (engine_gpgconf_t gpgconf)
+{
+  return _gpgme_strconcat (gpgconf->file_name, "\n",
+                           gpgconf->home_dir? gpgconf->home_dir : "", "\n",
+                           NULL);
+}
+
+
+/* Remove all entries for GPGCONF from the cache.  */
+static void
+conf_cache_invalidate (engine_gpgconf_t gpgconf)
+{
+  struct conf_cache_item_s *item, **itemp;
+  char *prefix;
+  size_t n;
+
+  prefix = conf_cache_prefix (gpgconf);
+  if (!prefix)
+    return;
+  n = strlen (prefix);
+
+  LOCK (conf_cache_lock);
+  itemp = &conf_cache;
+  while ((item = *itemp))
+    {
+      if (!strncmp (item->key, prefix, n))
+        {
+          *itemp = item->next;
+          free (item->lines);
+          free (item);
+        }
+      else
+        itemp = &item->next;
+    }
+  UNLOCK (conf_cache_lock);
+  free (prefix);
+}
+
+
+/* Add the output LINES of length LINESLEN with STAMP for KEY to the
+   cache, replacing an old entry.  LINES is taken over.  */
+static void
+conf_cache_put (const char *key, const struct conf_file_id_s *stamp,
+                char *lines, size_t lineslen)
+{
+  struct conf_cache_item_s *item, **itemp;
+
+  item = malloc (sizeof *item + strlen (key));
+  if (!item)
+    {
+      free (lines);
+      return;
+    }
+  memcpy (item->stamp, stamp, sizeof item->stamp);
+  item->lines = lines;
+  item->lineslen = lineslen;
+  strcpy (item->key, key);
+
+  LOCK (conf_cache_lock);
+  for (itemp = &conf_cache; *itemp; itemp = &(*itemp)->next)
+    if (!strcmp ((*itemp)->key, key))
+      {
+        struct conf_cache_item_s *old = *itemp;
+
+        *itemp = old->next;
+        free (old->lines);
+        free (old);
+        break;
+      }
+  item->next = conf_cache;
+  conf_cache = item;
+  UNLOCK (conf_cache_lock);
+}
+
+
+/* Return a copy of the cached output for KEY if it has the stamp
+   STAMP or NULL.  The length of the output is stored at R_LEN.  */
+static char *
+conf_cache_get (const char *key, const struct conf_file_id_s *stamp,
+                size_t *r_len)
+{
+  struct conf_cache_item_s *item;
+  char *lines = NULL;
+
+  LOCK (conf_cache_lock);
+  for (item = conf_cache; item; item = item->next)
+    if (!strcmp (item->key, key))
+      {
+        if (!memcmp (item->stamp, stamp, sizeof item->stamp))
+          {
+            /* Allocate one extra byte so that this never is a
+               zero-length allocation.  */
+            lines = malloc (item->lineslen + 1);
+            if (lines)
+              {
+                memcpy (lines, item->lines, item->lineslen);
+                *r_len = item->lineslen;
+              }
+          }
+        break;
+      }
+  UNLOCK (conf_cache_lock);
+  return lines;
+}
+
+
+/* Return the cache key for the output of gpgconf with the arguments
+   ARG1 and ARG2.  */
+static char *
+conf_cache_key (engine_gpgconf_t gpgconf, const char *arg1, const char *arg2)
+{
+  char *prefix, *key;
+
+  prefix = conf_cache_prefix (gpgconf);
+  if (!prefix)
+    return NULL;
+  key = _gpgme_strconcat (prefix, arg1, "\n", arg2? arg2 : "", "\n", NULL);
+  free (prefix);
+  return key;
+}
+
+
+/* Pass the Nul terminated lines in LINES of length LINESLEN to CB.
+   Empty lines are skipped.  The lines are modified by CB.  */
+static gpgme_error_t
+conf_feed_lines (char *lines, size_t lineslen,
+                 gpgme_error_t (*cb) (void *hook, char *line), void *hook)
+{
+  gpgme_error_t err = 0;
+  char *line;
+  size_t n;
+
+  for (line = lines; !err && line < lines + lineslen; line += n + 1)
+    {
+      /* CB modifies the line; thus get the length first.  */
+      n = strlen (line);
+      if (n)
+        err = cb (hook, line);
+    }
+  return err;
+}
+
+
+/* State of gpgconf_cached_read while running gpgconf.  */
+struct conf_collect_s
+{
+  gpgme_error_t (*cb) (void *hook, char *line);
+  void *hook;
+  char *lines;
+  size_t lineslen;
+  size_t size;
+};
+
+
+/* Append LINE to the collected output and pass it on.  */
+static gpgme_error_t
+conf_collect_cb (void *hook, char *line)
+{
+  struct conf_collect_s *collect = hook;
+  size_t n = strlen (line) + 1;
+
+  if (collect->lineslen + n > collect->size)
+    {
+      size_t newsize = collect->size? 2 * collect->size : 4096;
+      char *newlines;
+
+      while (newsize < collect->lineslen + n)
+        newsize *= 2;
+      newlines = realloc (collect->lines, newsize);
+      if (!newlines)
+        return gpg_error_from_syserror ();
+      collect->lines = newlines;
+      collect->size = newsize;
+    }
+  memcpy (collect->lines + collect->lineslen, line, n);
+  collect->lineslen += n;
+
+  return collect->cb (collect->hook, line);
+}
+
+
+/* A variant of gpgconf_read which takes the output from the
+   configuration cache if none of the configuration files has been
+   changed since it was stored.  ARG2 must be NULL or the name of a
+   component.  */
+static gpgme_error_t
+gpgconf_cached_read (void *engine, const char *arg1, char *arg2,
+                     gpgme_error_t (*cb) (void *hook, char *line),
+                     void *hook)
+{
+  engine_gpgconf_t gpgconf = engine;
+  gpgme_error_t err;
+  struct conf_file_id_s stamp[CONF_STAMP_FILES];
+  struct conf_collect_s collect;
+  char *key, *lines;
+  size_t lineslen;
+
+  key = conf_cache_key (gpgconf, arg1, arg2);
+  if (!key)
+    return gpg_error_from_syserror ();
+
+  /* The stamp is taken before running gpgconf so that a change while
+     gpgconf is running invalidates the entry.  */
+  conf_cache_stamp (gpgconf, arg2, stamp);
+
+  lines = conf_cache_get (key, stamp, &lineslen);
+  if (lines)
+    {
+      TRACE (DEBUG_ENGINE, "gpgme:gpgconf_cached_read", gpgconf,
+             "using cached output of %s %s", arg1, arg2? arg2 : "");
+      err = conf_feed_lines (lines, lineslen, cb, hook);
+      free (lines);
+      free (key);
+      return err;
+    }
+
+  memset (&collect, 0, sizeof collect);
+  collect.cb = cb;
+  collect.hook = hook;
+  err = gpgconf_read (engine, arg1, arg2, conf_collect_cb, &collect);
+  if (err)
+    free (collect.lines);
+  else
+    conf_cache_put (key, stamp, collect.lines, collect.lineslen);
+  free (key);
+  return err;
+}
+
+
+/* The output of "gpgconf --list-options" for one component.  */
+struct conf_job_s
+{
+  gpgme_conf_comp_t comp;
+  char *key;
+  struct conf_file_id_s stamp[CONF_STAMP_FILES];
+  /* True if LINES has been taken from the cache.  */
+  int cached;
+  /* The output.  While gpgconf is running this is the raw output,
+     afterwards each line is terminated by a Nul.  */
+  char *lines;
+  size_t lineslen;
+  size_t size;
+  /* The pid of gpgconf while it is running.  */
+  pid_t pid;
+};
+
+
+/* Return the number of gpgconf processes to run at the same time.  */
+static unsigned int
+max_conf_jobs (void)
+{
+  long n;
+
+#ifdef HAVE_W32_SYSTEM
+  SYSTEM_INFO si;
+
+  GetSystemInfo (&si);
+  n = si.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+  n = sysconf (_SC_NPROCESSORS_ONLN);
+#else
+  n = 1;
+#endif
+  return n < 1? 1 : n;
+}
+
+
+/* Read the available output of gpgconf from FD into JOB.  Sets
+   R_EOF at the end of the output.  */
+static gpgme_error_t
+conf_job_read (struct conf_job_s *job, int fd, int *r_eof)
+{
+  int nread;
+
+  if (job->size - job->lineslen < 1024)
+    {
+      size_t newsize = job->size? 2 * job->size : 8192;
+      char *newlines;
+
+      newlines = realloc (job->lines, newsize);
+      if (!newlines)
+        return gpg_error_from_syserror ();
+      job->lines = newlines;
+      job->size = newsize;
+    }
+
+  nread = _gpgme_io_read (fd, job->lines + job->lineslen,
+                          job->size - job->lineslen);
+  if (nread < 0)
+    return gpg_error_from_syserror ();
+  job->lineslen += nread;
+  *r_eof = !nread;
+  return 0;
+}
+
+
+/* Turn the raw output of JOB into Nul terminated lines.  Like
+   gpgconf_read this drops an incomplete last line and CRs.  */
+static void
+conf_job_split (struct conf_job_s *job)
+{
+  size_t i;
+
+  while (job->lineslen && job->lines[job->lineslen - 1] != '\n')
+    job->lineslen--;
+  for (i = 0; i < job->lineslen; i++)
+    if (job->lines[i] == '\n' || job->lines[i] == '\r')
+      job->lines[i] = 0;
+}
+
+
+/* Run "gpgconf --list-options" for all NJOBS JOBS which are not
+   taken from the cache.  At most one process per CPU is run at the
+   same time.  */
+static gpgme_error_t
+conf_run_jobs (engine_gpgconf_t gpgconf, struct conf_job_s *jobs, int njobs)
+{
+  gpgme_error_t err = 0;
+  struct io_select_fd_s *fds;
+  unsigned int maxrunning = max_conf_jobs ();
+  unsigned int running = 0;
+  int next = 0;
+  int i, nr, eof;
+
+  fds = calloc (njobs, sizeof *fds);
+  if (!fds)
+    return gpg_error_from_syserror ();
+  for (i = 0; i < njobs; i++)
+    fds[i].fd = -1;
+
+  for (;;)
+    {
+      while (running < maxrunning && next < njobs)
+        {
+          i = next++;
+          if (jobs[i].cached)
+            continue;
+          err = gpgconf_spawn (gpgconf, "--list-options",
+                               jobs[i].comp->name, &fds[i].fd, &jobs[i].pid);
+          if (err)
+            goto leave;
+          fds[i].for_read = 1;
+          running++;
+        }
+      if (!running)
+        break;
+
+      nr = _gpgme_io_select (fds, njobs, 0);
+      if (nr < 0)
+        {
+          err = gpg_error_from_syserror ();
+          goto leave;
+        }
+      for (i = 0; i < njobs && nr; i++)
+        {
+          if (fds[i].fd == -1 || !fds[i].signaled)
+            continue;
+          fds[i].signaled = 0;
+          nr--;
+
+          err = conf_job_read (&jobs[i], fds[i].fd, &eof);
+          if (err)
+            goto leave;
+          if (eof)
+            {
+              _gpgme_io_close (fds[i].fd);
+              fds[i].fd = -1;
+              _gpgme_io_spawn_wait (jobs[i].pid);
+              running--;
+              conf_job_split (&jobs[i]);
+            }
+        }
+    }
+
+ leave:
+  for (i = 0; i < njobs; i++)
+    if (fds[i].fd != -1)
+      {
+        _gpgme_io_close (fds[i].fd);
+        _gpgme_io_spawn_wait (jobs[i].pid);
+      }
+  free (fds);
   return err;
 }
 
@@ -560,8 +1069,12 @@ gpgconf_config_load_cb2 (void *hook, char *line)
 }
 
 
-static gpgme_error_t
-gpgconf_conf_load (void *engine, gpgme_conf_comp_t *comp_p)
+/* Load the configuration using READER to run gpgconf for ENGINE.
+   This is used by the replay engine, which provides its own
+   reader.  */
+gpgme_error_t
+_gpgme_conf_load_from (_gpgme_conf_reader_t reader, void *engine,
+                       gpgme_conf_comp_t *comp_p)
 {
   gpgme_error_t err;
   gpgme_conf_comp_t comp = NULL;
@@ -569,25 +1082,25 @@ gpgconf_conf_load (void *engine, gpgme_conf_comp_t *comp_p)
 
   *comp_p = NULL;
 
-  err = gpgconf_read (engine, "--list-components", NULL,
-		      gpgconf_config_load_cb, &comp);
+  err = reader (engine, "--list-components", NULL,
+                gpgconf_config_load_cb, &comp);
   if (err)
     {
-      gpgconf_release (comp);
+      gpgconf_config_release (comp);
       return err;
     }
 
   cur_comp = comp;
   while (!err && cur_comp)
     {
-      err = gpgconf_read (engine, "--list-options", cur_comp->name,
-			  gpgconf_config_load_cb2, cur_comp);
+      err = reader (engine, "--list-options", cur_comp->name,
+                    gpgconf_config_load_cb2, cur_comp);
       cur_comp = cur_comp->next;
     }
 
   if (err)
     {
-      gpgconf_release (comp);
+      gpgconf_config_release (comp);
       return err;
     }
 
@@ -596,6 +1109,100 @@ gpgconf_conf_load (void *engine, gpgme_conf_comp_t *comp_p)
 }
 
 
+/* Load the configuration.  Unlike _gpgme_conf_load_from this runs
+   gpgconf for all components at the same time, unless the output is
+   taken from the cache.  */
+static gpgme_error_t
+gpgconf_conf_load (void *engine, gpgme_conf_comp_t *comp_p)
+{
+  engine_gpgconf_t gpgconf = engine;
+  gpgme_error_t err;
+  gpgme_conf_comp_t comp = NULL;
+  gpgme_conf_comp_t cur_comp;
+  struct conf_job_s *jobs = NULL;
+  int njobs = 0;
+  int i;
+  char *copy;
+
+  *comp_p = NULL;
+
+  err = gpgconf_cached_read (engine, "--list-components", NULL,
+                             gpgconf_config_load_cb, &comp);
+  if (err)
+    goto leave;
+
+  for (cur_comp = comp; cur_comp; cur_comp = cur_comp->next)
+    njobs++;
+  if (!njobs)
+    goto leave;
+  jobs = calloc (njobs, sizeof *jobs);
+  if (!jobs)
+    {
+      err = gpg_error_from_syserror ();
+      goto leave;
+    }
+
+  for (i = 0, cur_comp = comp; cur_comp; i++, cur_comp = cur_comp->next)
+    {
+      jobs[i].comp = cur_comp;
+      jobs[i].key = conf_cache_key (gpgconf, "--list-options", cur_comp->name);
+      if (!jobs[i].key)
+        {
+          err = gpg_error_from_syserror ();
+          goto leave;
+        }
+      conf_cache_stamp (gpgconf, cur_comp->name, jobs[i].stamp);
+      jobs[i].lines = conf_cache_get (jobs[i].key, jobs[i].stamp,
+                                      &jobs[i].lineslen);
+      jobs[i].cached = !!jobs[i].lines;
+    }
+
+  err = conf_run_jobs (gpgconf, jobs, njobs);
+  if (err)
+    goto leave;
+
+  /* Parse the output in the order of the components.  */
+  for (i = 0; i < njobs; i++)
+    {
+      copy = NULL;
+      if (!jobs[i].cached)
+        {
+          /* The parser modifies the lines; thus cache a copy.  */
+          copy = malloc (jobs[i].lineslen + 1);
+          if (!copy)
+            {
+              err = gpg_error_from_syserror ();
+              goto leave;
+            }
+          memcpy (copy, jobs[i].lines, jobs[i].lineslen);
+        }
+
+      err = conf_feed_lines (jobs[i].lines, jobs[i].lineslen,
+                             gpgconf_config_load_cb2, jobs[i].comp);
+      if (err)
+        {
+          free (copy);
+          goto leave;
+        }
+      if (copy)
+        conf_cache_put (jobs[i].key, jobs[i].stamp, copy, jobs[i].lineslen);
+    }
+
+ leave:
+  for (i = 0; jobs && i < njobs; i++)
+    {
+      free (jobs[i].key);
+      free (jobs[i].lines);
+    }
+  free (jobs);
+  if (err)
+    gpgconf_config_release (comp);
+  else
+    *comp_p = comp;
+  return err;
+}
+
+
 
 gpgme_error_t
 _gpgme_conf_arg_new (gpgme_conf_arg_t *arg_p,
@@ -981,6 +1588,10 @@ gpgconf_conf_save (void *engine, gpgme_conf_comp_t comp)
     goto bail;
 
   err = gpgconf_write (engine, "--change-options", comp->name, conf);
+  /* The modification time of the configuration file may not change
+     if it is changed twice within one second; thus drop the cached
+     output right away.  */
+  conf_cache_invalidate (engine);
  bail:
   gpgme_data_release (conf);
   return err;
@@ -992,6 +992,7 @@ status_handler (void *opaque, int fd)
                 }
               src += nwritten;
               linelen -= nwritten;
+              data->stats->bytes_in += nwritten;
             }
 
           TRACE (DEBUG_CTX, "gpgme:status_handler", gpgsm,
@@ -1004,6 +1005,8 @@ status_handler (void *opaque, int fd)
 	  char *rest;
 	  gpgme_status_code_t r;
 
+	  data->stats->status_lines++;
+
 	  rest = strchr (line + 2, ' ');
 	  if (!rest)
 	    rest = line + linelen; /* set to an empty string */
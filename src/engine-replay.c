@@ -0,0 +1,1170 @@
+/* engine-replay.c - Answer operations from a recorded transcript
+ * Copyright (C) 2026 g10 Code GmbH
+ *
+ * This file is part of GPGME.
+ *
+ * GPGME is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * GPGME is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, see <https://gnu.org/licenses/>.
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+/* The replay engine does not run any program.  Instead it feeds the
+ * lines of a transcript file to the status and colon line handlers
+ * of the current operation, exactly as the gpg engine would do with
+ * the output of gpg.  This allows to benchmark and profile the
+ * parsers and the result construction without any process
+ * spawning.  A transcript consists of these lines:
+ *
+ *   [GNUPG:] KEYWORD ARGS   - A status line.
+ *   %data STRING            - Percent escaped data written to the
+ *                             output data object of the operation.
+ *   %section ARG1 [ARG2]    - Start of the output of "gpgconf ARG1
+ *                             ARG2"; only used by gpgme_op_conf_load.
+ *   # COMMENT               - Ignored, as are empty lines and
+ *                             unknown % directives.
+ *
+ * All other lines are colon lines.  A transcript for a key listing
+ * can thus be recorded with
+ *
+ *   gpg --batch --status-fd 1 --with-colons --list-keys >keylist.trans
+ *
+ * By default the transcript is replayed directly from the I/O
+ * callback of a pipe which is already at EOF and the input data
+ * objects of an operation are not read.  If the context flag
+ * "replay-pace" is set, a feeder thread plays the part of gpg
+ * instead: It reads the input data from a socket pumped by the
+ * regular data handlers, waits for the configured latency, and writes
+ * the status and colon lines and the data to sockets at the
+ * configured rate.  This exercises the event loops and the data
+ * pumping as a real engine does, without the cost of the crypto.  */
+
+#if HAVE_CONFIG_H
+#include <config.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#ifndef HAVE_W32_SYSTEM
+# include <time.h>
+# include <unistd.h>
+# include <sys/types.h>
+# include <sys/socket.h>
+# include <poll.h>
+# include <pthread.h>
+#endif
+
+#include "gpgme.h"
+#include "util.h"
+#include "ops.h"
+#include "wait.h"
+#include "context.h"
+#include "priv-io.h"
+#include "debug.h"
+
+#include "engine-backend.h"
+
+
+/* The indices of the fds used for an operation.  In the direct mode
+ * only FD_STATUS is used.  */
+enum { FD_STATUS, FD_DATA, FD_INPUT, N_FDS };
+
+
+struct engine_replay
+{
+  /* The transcript file name and its content.  BUFFER is always
+   * Nul-terminated.  */
+  char *file_name;
+  char *buffer;
+  size_t buflen;
+
+  /* Scratch space for the line currently given to a handler.  */
+  char *line;
+  size_t linesize;
+
+  struct
+  {
+    engine_status_handler_t fnc;
+    void *fnc_value;
+    gpgme_status_cb_t mon_cb;
+    void *mon_cb_value;
+  } status;
+
+  struct
+  {
+    engine_colon_line_handler_t fnc;
+    void *fnc_value;
+  } colon;
+
+  /* The data object receiving the %data lines or NULL.  */
+  gpgme_data_t output;
+
+  /* The fds of the operation and their I/O callback tags.  */
+  struct
+  {
+    int fd;
+    void *tag;
+  } fds[N_FDS];
+
+  /* The latency in microseconds and the rate in bytes per second of
+   * the paced mode.  The paced mode is used if one of them is set.  */
+  unsigned long latency;
+  unsigned long rate;
+
+  /* The read buffer for the status socket of the paced mode.  */
+  char *sbuffer;
+  size_t sbufsize;
+  size_t sreadpos;
+
+#ifndef HAVE_W32_SYSTEM
+  /* The feeder thread of the paced mode and its ends of the
+   * sockets.  */
+  struct
+  {
+    pthread_t thread;
+    int running;
+    int fds[N_FDS];
+    unsigned long long start;
+  } feeder;
+#endif
+
+  struct gpgme_io_cbs io_cbs;
+};
+typedef struct engine_replay *engine_replay_t;
+
+
+static void replay_io_event (void *engine,
+                             gpgme_event_io_t type, void *type_data);
+static gpgme_error_t replay_cancel (void *engine);
+
+
+
+/* Read the entire file FILE_NAME into a malloced and Nul-terminated
+ * buffer which is stored at R_BUFFER.  */
+static gpgme_error_t
+read_transcript (const char *file_name, char **r_buffer, size_t *r_buflen)
+{
+  gpgme_error_t err = 0;
+  FILE *fp;
+  char *buffer = NULL;
+  size_t buflen = 0;
+  size_t bufsize = 0;
+  size_t nread;
+
+  fp = fopen (file_name, "rb");
+  if (!fp)
+    return gpg_error_from_syserror ();
+
+  do
+    {
+      if (bufsize - buflen < 4096)
+        {
+          char *newbuf;
+
+          bufsize = bufsize? 2 * bufsize : 65536;
+          newbuf = realloc (buffer, bufsize + 1);
+          if (!newbuf)
+            {
+              err = gpg_error_from_syserror ();
+              goto leave;
+            }
+          buffer = newbuf;
+        }
+      nread = fread (buffer + buflen, 1, bufsize - buflen, fp);
+      buflen += nread;
+    }
+  while (nread);
+
+  if (ferror (fp))
+    {
+      err = gpg_error_from_syserror ();
+      goto leave;
+    }
+  buffer[buflen] = 0;
+
+ leave:
+  fclose (fp);
+  if (err)
+    free (buffer);
+  else
+    {
+      *r_buffer = buffer;
+      *r_buflen = buflen;
+    }
+  return err;
+}
+
+
+/* Return the next line of the transcript at *R_POS and advance *R_POS
+ * to the next line.  The returned line is a copy which may be
+ * modified by the caller.  NULL is returned at the end of the
+ * transcript or on error; in the latter case *R_ERR is set.  */
+static char *
+next_line (engine_replay_t re, size_t *r_pos, gpgme_error_t *r_err)
+{
+  const char *start, *end;
+  size_t len;
+
+  *r_err = 0;
+  if (*r_pos >= re->buflen)
+    return NULL;
+
+  start = re->buffer + *r_pos;
+  end = strchr (start, '\n');
+  if (!end)
+    end = re->buffer + re->buflen;
+  *r_pos = end - re->buffer + 1;
+
+  len = end - start;
+  if (len && start[len-1] == '\r')
+    len--;
+
+  if (len + 1 > re->linesize)
+    {
+      char *newline;
+      size_t newsize = re->linesize? re->linesize : 1024;
+
+      while (newsize < len + 1)
+        newsize *= 2;
+      newline = realloc (re->line, newsize);
+      if (!newline)
+        {
+          *r_err = gpg_error_from_syserror ();
+          return NULL;
+        }
+      re->line = newline;
+      re->linesize = newsize;
+    }
+  memcpy (re->line, start, len);
+  re->line[len] = 0;
+  return re->line;
+}
+
+
+/* Decode the percent escaped string SRC of length LEN into DST, which
+ * may be the same as SRC.  Returns the length of the result or -1 on
+ * an invalid escape.  */
+static gpgme_ssize_t
+percent_decode (char *dst, const char *src, size_t len)
+{
+  const char *end = src + len;
+  char *start = dst;
+
+  while (src < end)
+    {
+      if (*src == '%')
+        {
+          int c = end - src > 2? _gpgme_hextobyte (src + 1) : -1;
+
+          if (c == -1)
+            return -1;
+          *dst++ = c;
+          src += 3;
+        }
+      else
+        *dst++ = *src++;
+    }
+  return dst - start;
+}
+
+
+/* Decode the percent escaped STRING in place and write it to the
+ * output data object.  */
+static gpgme_error_t
+write_data (engine_replay_t re, char *string)
+{
+  char *src;
+  gpgme_ssize_t nwritten;
+  gpgme_ssize_t len;
+
+  if (!re->output)
+    return 0;
+
+  len = percent_decode (string, string, strlen (string));
+  if (len < 0)
+    return trace_gpg_error (GPG_ERR_INV_ENGINE);
+
+  for (src = string; len; len -= nwritten, src += nwritten)
+    {
+      nwritten = gpgme_data_write (re->output, src, len);
+      if (nwritten < 0)
+        return gpg_error_from_syserror ();
+    }
+  return 0;
+}
+
+
+/* Process one transcript LINE.  */
+static gpgme_error_t
+replay_line (engine_replay_t re, char *line, gpgme_op_stats_t stats)
+{
+  gpgme_error_t err = 0;
+
+  if (!*line || *line == '#')
+    return 0;
+
+  if (*line == '%')
+    {
+      if (!strncmp (line, "%data", 5) && (!line[5] || line[5] == ' '))
+        err = write_data (re, line[5]? line + 6 : line + 5);
+    }
+  else if (!strncmp (line, "[GNUPG:] ", 9)
+           && line[9] >= 'A' && line[9] <= 'Z')
+    {
+      char *rest;
+      gpgme_status_code_t r;
+
+      rest = strchr (line + 9, ' ');
+      if (!rest)
+        rest = line + strlen (line);
+      else
+        *rest++ = 0;
+
+      r = _gpgme_parse_status (line + 9);
+      stats->status_lines++;
+      if (re->status.mon_cb && r != GPGME_STATUS_PROGRESS)
+        {
+          err = re->status.mon_cb (re->status.mon_cb_value, line + 9, rest);
+          if (err)
+            return err;
+        }
+      if (r >= 0 && re->status.fnc)
+        {
+          err = re->status.fnc (re->status.fnc_value, r, rest);
+          if (gpg_err_code (err) == GPG_ERR_FALSE)
+            err = 0; /* Drop special error code.  */
+        }
+    }
+  else if (re->colon.fnc)
+    err = re->colon.fnc (re->colon.fnc_value, line);
+
+  return err;
+}
+
+
+/* Signal the end of the engine output to the handlers.  */
+static gpgme_error_t
+replay_finish (engine_replay_t re)
+{
+  gpgme_error_t err = 0;
+
+  if (re->colon.fnc)
+    err = re->colon.fnc (re->colon.fnc_value, NULL);
+  if (!err && re->status.mon_cb)
+    err = re->status.mon_cb (re->status.mon_cb_value, "", "");
+  if (!err && re->status.fnc)
+    {
+      char emptystring[1] = {0};
+
+      err = re->status.fnc (re->status.fnc_value,
+                            GPGME_STATUS_EOF, emptystring);
+      if (gpg_err_code (err) == GPG_ERR_FALSE)
+        err = 0; /* Drop special error code.  */
+    }
+  return err;
+}
+
+
+/* The I/O callback for the trigger fd of the direct mode.  This
+ * replays the entire transcript and signals the end of the output to
+ * the handlers.  */
+static gpgme_error_t
+replay_handler (void *opaque, int fd)
+{
+  struct io_cb_data *data = (struct io_cb_data *) opaque;
+  engine_replay_t re = (engine_replay_t) data->handler_value;
+  gpgme_error_t err = 0;
+  size_t pos = 0;
+  char *line;
+
+  TRACE_SPAN_BEGIN ("replay", re);
+  while ((line = next_line (re, &pos, &err)))
+    {
+      err = replay_line (re, line, data->stats);
+      if (err)
+        break;
+    }
+  if (!err)
+    err = replay_finish (re);
+  TRACE_SPAN_END ("replay", re);
+
+  if (!err)
+    _gpgme_io_close (fd);
+  return err;
+}
+
+
+/* The I/O callback for the status socket of the paced mode.  */
+static gpgme_error_t
+status_handler (void *opaque, int fd)
+{
+  struct io_cb_data *data = (struct io_cb_data *) opaque;
+  engine_replay_t re = (engine_replay_t) data->handler_value;
+  gpgme_error_t err;
+  int nread;
+  char *line, *p;
+
+  if (re->sbufsize - re->sreadpos < 256)
+    {
+      size_t newsize = re->sbufsize? 2 * re->sbufsize : 4096;
+      char *newbuf = realloc (re->sbuffer, newsize);
+
+      if (!newbuf)
+        return gpg_error_from_syserror ();
+      re->sbuffer = newbuf;
+      re->sbufsize = newsize;
+    }
+
+  nread = _gpgme_io_read (fd, re->sbuffer + re->sreadpos,
+                          re->sbufsize - re->sreadpos);
+  if (nread < 0)
+    return gpg_error_from_syserror ();
+  if (!nread)
+    {
+      err = replay_finish (re);
+      if (!err)
+        _gpgme_io_close (fd);
+      return err;
+    }
+  re->sreadpos += nread;
+
+  /* Process all complete lines.  */
+  line = re->sbuffer;
+  while ((p = memchr (line, '\n', re->sbuffer + re->sreadpos - line)))
+    {
+      if (p > line && p[-1] == '\r')
+        p[-1] = 0;
+      *p = 0;
+      err = replay_line (re, line, data->stats);
+      if (err)
+        return err;
+      line = p + 1;
+    }
+  re->sreadpos -= line - re->sbuffer;
+  memmove (re->sbuffer, line, re->sreadpos);
+  return 0;
+}
+
+
+static void
+close_notify_handler (int fd, void *opaque)
+{
+  engine_replay_t re = opaque;
+  int i;
+
+  assert (fd != -1);
+
+  for (i = 0; i < N_FDS; i++)
+    if (re->fds[i].fd == fd)
+      {
+        if (re->fds[i].tag)
+          (*re->io_cbs.remove) (re->fds[i].tag);
+        re->fds[i].tag = NULL;
+        re->fds[i].fd = -1;
+        break;
+      }
+}
+
+
+/* Register the engine's end FD of a pipe or socket with index IDX.  */
+static gpgme_error_t
+add_fd (engine_replay_t re, int idx, int fd, int dir,
+        gpgme_io_cb_t handler, void *data)
+{
+  if (_gpgme_io_set_close_notify (fd, close_notify_handler, re))
+    {
+      _gpgme_io_close (fd);
+      return gpg_error (GPG_ERR_GENERAL);
+    }
+  re->fds[idx].fd = fd;
+
+  if (!dir && _gpgme_io_set_nonblocking (fd))
+    return gpg_error_from_syserror ();
+  return (*re->io_cbs.add) (re->io_cbs.add_priv, fd, dir,
+                            handler, data, &re->fds[idx].tag);
+}
+
+
+#ifndef HAVE_W32_SYSTEM
+/* Sleep until the time USEC as returned by _gpgme_get_usec.  The
+ * sleep is cut short if the other end of the socket FD is closed
+ * because the operation has been canceled; -1 is returned in that
+ * case.  poll has only a resolution of milliseconds, thus the rest
+ * is slept with nanosleep.  */
+static int
+sleep_until (int fd, unsigned long long usec)
+{
+  unsigned long long now;
+  struct pollfd pfd;
+  struct timespec ts;
+  int timeout, n;
+
+  for (;;)
+    {
+      now = _gpgme_get_usec ();
+      if (usec <= now)
+        return 0;
+      if (usec - now < 1000)
+        break;
+      timeout = (usec - now) / 1000 > 60000? 60000 : (usec - now) / 1000;
+      pfd.fd = fd;
+      pfd.events = 0;
+      pfd.revents = 0;
+      n = poll (&pfd, 1, timeout);
+      if (n < 0 && errno != EINTR)
+        return -1;
+      if (n > 0 && (pfd.revents & (POLLHUP | POLLERR | POLLNVAL)))
+        return -1;
+    }
+
+  usec -= now;
+  ts.tv_sec = 0;
+  ts.tv_nsec = usec * 1000;
+  while (nanosleep (&ts, &ts) && errno == EINTR)
+    ;
+  return 0;
+}
+
+
+/* Write LEN bytes from BUFFER to the socket FD.  Using send avoids a
+ * SIGPIPE if the operation has been canceled.  */
+static int
+feeder_send (int fd, const char *buffer, size_t len)
+{
+  ssize_t n;
+
+  while (len)
+    {
+      n = send (fd, buffer, len, MSG_NOSIGNAL);
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n < 0)
+        return -1;
+      buffer += n;
+      len -= n;
+    }
+  return 0;
+}
+
+
+/* The feeder thread of the paced mode.  It only accesses the
+ * transcript, which is not changed while the thread is running, and
+ * its own ends of the sockets.  */
+static void *
+feeder_main (void *opaque)
+{
+  engine_replay_t re = opaque;
+  int *fds = re->feeder.fds;
+  unsigned long long first = re->feeder.start + re->latency;
+  unsigned long long sent = 0;
+  const char *line, *end;
+  char *data = NULL;
+  char buffer[4096];
+  gpgme_ssize_t len;
+  ssize_t n;
+  int i;
+
+  /* Consume the input as gpg would do.  */
+  if (fds[FD_INPUT] != -1)
+    while ((n = read (fds[FD_INPUT], buffer, sizeof buffer)) > 0
+           || (n < 0 && errno == EINTR))
+      ;
+
+  for (line = re->buffer; line < re->buffer + re->buflen; line = end + 1)
+    {
+      const char *p = line;
+      int fd = fds[FD_STATUS];
+
+      end = strchr (line, '\n');
+      if (!end)
+        end = re->buffer + re->buflen;
+      len = end - line;
+      if (!len || *line == '#')
+        continue;
+
+      if (!strncmp (line, "%data", 5) && (len == 5 || line[5] == ' '))
+        {
+          char *tmp;
+
+          fd = fds[FD_DATA];
+          if (fd == -1 || len == 5)
+            continue;
+          tmp = realloc (data, len);
+          if (!tmp)
+            break;
+          data = tmp;
+          len = percent_decode (data, line + 6, len - 6);
+          if (len < 0)
+            break;
+          p = data;
+        }
+      else if (*line == '%')
+        continue;
+      else if (*end)
+        len++;  /* Include the LF.  */
+
+      if (sleep_until (fds[FD_STATUS],
+                       first + (re->rate? sent * 1000000 / re->rate : 0))
+          || feeder_send (fd, p, len)
+          || (!*end && fd == fds[FD_STATUS] && feeder_send (fd, "\n", 1)))
+        break;
+      sent += len;
+    }
+
+  free (data);
+  for (i = 0; i < N_FDS; i++)
+    if (fds[i] != -1)
+      close (fds[i]);
+  return NULL;
+}
+
+
+/* Start the paced replay of the transcript.  */
+static gpgme_error_t
+paced_start (engine_replay_t re, gpgme_data_t input, gpgme_data_t output)
+{
+  gpgme_error_t err = 0;
+  int sv[2];
+  int i, rc;
+
+  for (i = 0; i < N_FDS; i++)
+    re->feeder.fds[i] = -1;
+
+  for (i = 0; !err && i < N_FDS; i++)
+    {
+      if ((i == FD_DATA && !output) || (i == FD_INPUT && !input))
+        continue;
+      if (socketpair (AF_UNIX, SOCK_STREAM, 0, sv))
+        {
+          err = gpg_error_from_syserror ();
+          break;
+        }
+      re->feeder.fds[i] = sv[1];
+      if (i == FD_STATUS)
+        err = add_fd (re, i, sv[0], 1, status_handler, re);
+      else if (i == FD_DATA)
+        err = add_fd (re, i, sv[0], 1, _gpgme_data_inbound_handler, output);
+      else
+        err = add_fd (re, i, sv[0], 0, _gpgme_data_outbound_handler, input);
+    }
+
+  if (!err)
+    {
+      re->feeder.start = _gpgme_get_usec ();
+      rc = pthread_create (&re->feeder.thread, NULL, feeder_main, re);
+      if (rc)
+        err = gpg_error_from_errno (rc);
+      else
+        re->feeder.running = 1;
+    }
+
+  if (err && !re->feeder.running)
+    for (i = 0; i < N_FDS; i++)
+      if (re->feeder.fds[i] != -1)
+        close (re->feeder.fds[i]);
+  return err;
+}
+#endif /*!HAVE_W32_SYSTEM*/
+
+
+/* Start the replay of the transcript for the current operation with
+ * the data objects INPUT and OUTPUT, which may be NULL.  In the
+ * direct mode the transcript is replayed as soon as the event loop
+ * runs the I/O callback of a pipe whose write end has already been
+ * closed.  */
+static gpgme_error_t
+replay_start (engine_replay_t re, gpgme_data_t input, gpgme_data_t output)
+{
+  gpgme_error_t err;
+  int fds[2];
+
+  re->output = output;
+
+#ifndef HAVE_W32_SYSTEM
+  if (re->latency || re->rate)
+    err = paced_start (re, input, output);
+  else
+#else
+  (void)input;
+#endif
+    {
+      if (_gpgme_io_pipe (fds, 0) < 0)
+        return gpg_error_from_syserror ();
+      _gpgme_io_close (fds[1]);
+      err = add_fd (re, FD_STATUS, fds[0], 1, replay_handler, re);
+    }
+  if (err)
+    {
+      replay_cancel (re);
+      return err;
+    }
+
+  replay_io_event (re, GPGME_EVENT_START, NULL);
+  return 0;
+}
+
+
+/* Run CB for all lines of the transcript section matching the gpgconf
+ * arguments ARG1 and ARG2.  This is the replacement of gpgconf_read
+ * of the gpgconf engine.  */
+static gpgme_error_t
+replay_conf_read (void *engine, const char *arg1, char *arg2,
+                  gpgme_error_t (*cb) (void *hook, char *line),
+                  void *hook)
+{
+  engine_replay_t re = engine;
+  gpgme_error_t err = 0;
+  size_t pos = 0;
+  char *line;
+  int in_section = 0;
+
+  while ((line = next_line (re, &pos, &err)))
+    {
+      if (!strncmp (line, "%section ", 9))
+        {
+          char *p = line + 9;
+          size_t n = strlen (arg1);
+
+          if (in_section)
+            break;
+          in_section = !strncmp (p, arg1, n);
+          if (in_section && arg2)
+            in_section = (p[n] == ' ' && !strcmp (p + n + 1, arg2));
+          else if (in_section)
+            in_section = !p[n];
+        }
+      else if (in_section && *line && *line != '#' && *line != '%')
+        {
+          err = (*cb) (hook, line);
+          if (err)
+            break;
+        }
+    }
+
+  return err;
+}
+
+
+
+/*
+    Public functions
+ */
+
+static gpgme_error_t
+replay_new (void **engine, const char *file_name, const char *home_dir,
+            const char *version)
+{
+  gpgme_error_t err;
+  engine_replay_t re;
+  int i;
+
+  (void)home_dir;
+  (void)version;
+
+  re = calloc (1, sizeof *re);
+  if (!re)
+    return gpg_error_from_syserror ();
+  for (i = 0; i < N_FDS; i++)
+    re->fds[i].fd = -1;
+
+  re->file_name = strdup (file_name);
+  if (!re->file_name)
+    {
+      err = gpg_error_from_syserror ();
+      free (re);
+      return err;
+    }
+
+  err = read_transcript (file_name, &re->buffer, &re->buflen);
+  if (err)
+    {
+      free (re->file_name);
+      free (re);
+      return err;
+    }
+
+  *engine = re;
+  return 0;
+}
+
+
+static gpgme_error_t
+replay_cancel (void *engine)
+{
+  engine_replay_t re = engine;
+  int i;
+
+  if (!re)
+    return gpg_error (GPG_ERR_INV_VALUE);
+
+  for (i = 0; i < N_FDS; i++)
+    if (re->fds[i].fd != -1)
+      _gpgme_io_close (re->fds[i].fd);
+
+#ifndef HAVE_W32_SYSTEM
+  /* Closing our ends of the sockets makes the feeder terminate; this
+   * also wakes it up if it is waiting for the next pacing deadline.  */
+  if (re->feeder.running)
+    {
+      pthread_join (re->feeder.thread, NULL);
+      re->feeder.running = 0;
+    }
+#endif
+  re->sreadpos = 0;
+
+  return 0;
+}
+
+
+static void
+replay_release (void *engine)
+{
+  engine_replay_t re = engine;
+
+  if (!re)
+    return;
+
+  replay_cancel (re);
+  free (re->sbuffer);
+  free (re->line);
+  free (re->buffer);
+  free (re->file_name);
+  free (re);
+}
+
+
+/* The transcript is kept and replayed again for the next
+ * operation.  */
+static gpgme_error_t
+replay_reset (void *engine)
+{
+  engine_replay_t re = engine;
+
+  replay_cancel (re);
+  re->status.fnc = NULL;
+  re->status.fnc_value = NULL;
+  re->status.mon_cb = NULL;
+  re->status.mon_cb_value = NULL;
+  re->colon.fnc = NULL;
+  re->colon.fnc_value = NULL;
+  re->output = NULL;
+  return 0;
+}
+
+
+static void
+replay_set_status_cb (void *engine, gpgme_status_cb_t cb, void *cb_value)
+{
+  engine_replay_t re = engine;
+
+  re->status.mon_cb = cb;
+  re->status.mon_cb_value = cb_value;
+}
+
+
+static void
+replay_set_status_handler (void *engine, engine_status_handler_t fnc,
+                           void *fnc_value)
+{
+  engine_replay_t re = engine;
+
+  re->status.fnc = fnc;
+  re->status.fnc_value = fnc_value;
+}
+
+
+static void
+replay_set_engine_flags (void *engine, const gpgme_ctx_t ctx)
+{
+  engine_replay_t re = engine;
+
+#ifndef HAVE_W32_SYSTEM
+  re->latency = ctx->replay_latency;
+  re->rate = ctx->replay_rate;
+#else
+  (void)re;
+  (void)ctx;
+#endif
+}
+
+
+static gpgme_error_t
+replay_set_colon_line_handler (void *engine, engine_colon_line_handler_t fnc,
+                               void *fnc_value)
+{
+  engine_replay_t re = engine;
+
+  re->colon.fnc = fnc;
+  re->colon.fnc_value = fnc_value;
+  return 0;
+}
+
+
+static gpgme_error_t
+replay_decrypt (void *engine, gpgme_decrypt_flags_t flags,
+                gpgme_data_t ciph, gpgme_data_t plain,
+                int export_session_key, const char *override_session_key,
+                int auto_key_retrieve)
+{
+  (void)flags;
+  (void)ciph;
+  (void)export_session_key;
+  (void)override_session_key;
+  (void)auto_key_retrieve;
+
+  return replay_start (engine, ciph, plain);
+}
+
+
+static gpgme_error_t
+replay_delete (void *engine, gpgme_key_t key, unsigned int flags)
+{
+  (void)key;
+  (void)flags;
+
+  return replay_start (engine, NULL, NULL);
+}
+
+
+static gpgme_error_t
+replay_encrypt (void *engine, gpgme_key_t recp[], const char *recpstring,
+                gpgme_encrypt_flags_t flags,
+                gpgme_data_t plain, gpgme_data_t ciph, int use_armor)
+{
+  (void)recp;
+  (void)recpstring;
+  (void)flags;
+  (void)use_armor;
+
+  return replay_start (engine, plain, ciph);
+}
+
+
+static gpgme_error_t
+replay_encrypt_sign (void *engine, gpgme_key_t recp[],
+                     const char *recpstring, gpgme_encrypt_flags_t flags,
+                     gpgme_data_t plain, gpgme_data_t ciph, int use_armor,
+                     gpgme_ctx_t ctx)
+{
+  (void)ctx;
+
+  return replay_encrypt (engine, recp, recpstring, flags,
+                         plain, ciph, use_armor);
+}
+
+
+static gpgme_error_t
+replay_export (void *engine, const char *pattern, gpgme_export_mode_t mode,
+               gpgme_data_t keydata, int use_armor)
+{
+  (void)pattern;
+  (void)mode;
+  (void)use_armor;
+
+  return replay_start (engine, NULL, keydata);
+}
+
+
+static gpgme_error_t
+replay_export_ext (void *engine, const char *pattern[],
+                   gpgme_export_mode_t mode, gpgme_data_t keydata,
+                   int use_armor)
+{
+  (void)pattern;
+  (void)mode;
+  (void)use_armor;
+
+  return replay_start (engine, NULL, keydata);
+}
+
+
+static gpgme_error_t
+replay_genkey (void *engine, const char *userid, const char *algo,
+               unsigned long reserved, unsigned long expires,
+               gpgme_key_t key, unsigned int flags,
+               gpgme_data_t help_data, unsigned int extraflags,
+               gpgme_data_t pubkey, gpgme_data_t seckey)
+{
+  (void)userid;
+  (void)algo;
+  (void)reserved;
+  (void)expires;
+  (void)key;
+  (void)flags;
+  (void)extraflags;
+  (void)seckey;
+
+  return replay_start (engine, help_data, pubkey);
+}
+
+
+static gpgme_error_t
+replay_import (void *engine, gpgme_data_t keydata, gpgme_key_t *keyarray)
+{
+  (void)keyarray;
+
+  return replay_start (engine, keydata, NULL);
+}
+
+
+static gpgme_error_t
+replay_keylist (void *engine, const char *pattern, int secret_only,
+                gpgme_keylist_mode_t mode, int engine_flags)
+{
+  (void)pattern;
+  (void)secret_only;
+  (void)mode;
+  (void)engine_flags;
+
+  return replay_start (engine, NULL, NULL);
+}
+
+
+static gpgme_error_t
+replay_keylist_ext (void *engine, const char *pattern[], int secret_only,
+                    int reserved, gpgme_keylist_mode_t mode,
+                    int engine_flags)
+{
+  (void)pattern;
+  (void)secret_only;
+  (void)reserved;
+  (void)mode;
+  (void)engine_flags;
+
+  return replay_start (engine, NULL, NULL);
+}
+
+
+static gpgme_error_t
+replay_keylist_data (void *engine, gpgme_data_t data)
+{
+  return replay_start (engine, data, NULL);
+}
+
+
+static gpgme_error_t
+replay_sign (void *engine, gpgme_data_t in, gpgme_data_t out,
+             gpgme_sig_mode_t mode, int use_armor, int use_textmode,
+             int include_certs, gpgme_ctx_t ctx)
+{
+  (void)mode;
+  (void)use_armor;
+  (void)use_textmode;
+  (void)include_certs;
+  (void)ctx;
+
+  return replay_start (engine, in, out);
+}
+
+
+static gpgme_error_t
+replay_trustlist (void *engine, const char *pattern)
+{
+  (void)pattern;
+
+  return replay_start (engine, NULL, NULL);
+}
+
+
+static gpgme_error_t
+replay_verify (void *engine, gpgme_data_t sig, gpgme_data_t signed_text,
+               gpgme_data_t plaintext, gpgme_ctx_t ctx)
+{
+  (void)signed_text;
+  (void)ctx;
+
+  return replay_start (engine, sig, plaintext);
+}
+
+
+static gpgme_error_t
+replay_conf_load (void *engine, gpgme_conf_comp_t *comp_p)
+{
+  return _gpgme_conf_load_from (replay_conf_read, engine, comp_p);
+}
+
+
+static void
+replay_set_io_cbs (void *engine, gpgme_io_cbs_t io_cbs)
+{
+  engine_replay_t re = engine;
+
+  re->io_cbs = *io_cbs;
+}
+
+
+static void
+replay_io_event (void *engine, gpgme_event_io_t type, void *type_data)
+{
+  engine_replay_t re = engine;
+
+  TRACE (DEBUG_ENGINE, "gpgme:replay_io_event", re,
+          "event %p, type %d, type_data %p",
+          re->io_cbs.event, type, type_data);
+  if (re->io_cbs.event)
+    (*re->io_cbs.event) (re->io_cbs.event_priv, type, type_data);
+}
+
+
+
+struct engine_ops _gpgme_engine_ops_replay =
+  {
+    /* Static functions.  */
+    NULL,               /* get_file_name */
+    NULL,               /* get_home_dir */
+    NULL,               /* get_version */
+    NULL,               /* get_req_version */
+    replay_new,
+
+    /* Member functions.  */
+    replay_release,
+    replay_reset,
+    replay_set_status_cb,
+    replay_set_status_handler,
+    NULL,		/* set_command_handler */
+    replay_set_colon_line_handler,
+    NULL,		/* set_locale */
+    NULL,		/* set_protocol */
+    replay_set_engine_flags,
+    replay_decrypt,
+    replay_delete,
+    NULL,		/* edit */
+    replay_encrypt,
+    replay_encrypt_sign,
+    replay_export,
+    replay_export_ext,
+    replay_genkey,
+    replay_import,
+    replay_keylist,
+    replay_keylist_ext,
+    replay_keylist_data,
+    NULL,               /* keysign */
+    NULL,               /* tofu_policy */
+    replay_sign,
+    replay_trustlist,
+    replay_verify,
+    NULL,		/* getauditlog */
+    NULL,               /* opassuan_transact */
+    replay_conf_load,
+    NULL,		/* conf_save */
+    NULL,		/* conf_dir */
+    NULL,               /* query_swdb */
+    replay_set_io_cbs,
+    replay_io_event,
+    replay_cancel,
+    NULL,               /* cancel_op */
+    NULL,               /* passwd */
+    NULL,               /* set_pinentry_mode */
+    NULL                /* opspawn */
+  };
@@ -223,8 +223,20 @@ gpgme_get_engine_info (gpgme_engine_info_t *info)
 					GPGME_PROTOCOL_G13,
 					GPGME_PROTOCOL_UISERVER,
                                         GPGME_PROTOCOL_SPAWN    };
+      /* The engines which need to be run to get their version.  */
+      gpgme_protocol_t probe_list[] = { GPGME_PROTOCOL_OpenPGP,
+                                        GPGME_PROTOCOL_CMS,
+                                        GPGME_PROTOCOL_GPGCONF,
+                                        GPGME_PROTOCOL_G13 };
+      const char *probe_names[DIM (probe_list)];
       unsigned int proto;
 
+      /* Start all version probes at once; the loop below then picks
+       * up the cached results.  */
+      for (proto = 0; proto < DIM (probe_list); proto++)
+        probe_names[proto] = engine_get_file_name (probe_list[proto]);
+      _gpgme_prefetch_program_versions (probe_names, DIM (probe_list));
+
       err = 0;
       for (proto = 0; proto < DIM (proto_list); proto++)
 	{
@@ -307,28 +319,16 @@ gpgme_get_engine_info (gpgme_engine_info_t *info)
 }
 
 
-/* Get a deep copy of the engine info and return it in INFO.  */
-gpgme_error_t
-_gpgme_engine_info_copy (gpgme_engine_info_t *r_info)
+/* Store a deep copy of the engine info list INFO at R_INFO.  The
+ * caller must make sure that INFO is not modified while this function
+ * runs.  */
+static gpgme_error_t
+engine_info_copy_list (gpgme_engine_info_t *r_info, gpgme_engine_info_t info)
 {
   gpgme_error_t err = 0;
-  gpgme_engine_info_t info;
   gpgme_engine_info_t new_info;
   gpgme_engine_info_t *lastp;
 
-  LOCK (engine_info_lock);
-  info = engine_info;
-  if (!info)
-    {
-      /* Make sure it is initialized.  */
-      UNLOCK (engine_info_lock);
-      err = gpgme_get_engine_info (&info);
-      if (err)
-	return err;
-
-      LOCK (engine_info_lock);
-    }
-
   new_info = NULL;
   lastp = &new_info;
 
@@ -375,7 +375,6 @@ _gpgme_engine_info_copy (gpgme_engine_info_t *r_info)
 	  if (version)
 	    free (version);
 
-	  UNLOCK (engine_info_lock);
 	  return err;
 	}
 
@@ -391,11 +390,47 @@ _gpgme_engine_info_copy (gpgme_engine_info_t *r_info)
     }
 
   *r_info = new_info;
-  UNLOCK (engine_info_lock);
   return 0;
 }
 
 
+/* Get a deep copy of the engine info and return it in INFO.  */
+gpgme_error_t
+_gpgme_engine_info_copy (gpgme_engine_info_t *r_info)
+{
+  gpgme_error_t err;
+  gpgme_engine_info_t info;
+
+  LOCK (engine_info_lock);
+  info = engine_info;
+  if (!info)
+    {
+      /* Make sure it is initialized.  */
+      UNLOCK (engine_info_lock);
+      err = gpgme_get_engine_info (&info);
+      if (err)
+	return err;
+
+      LOCK (engine_info_lock);
+    }
+
+  err = engine_info_copy_list (r_info, info);
+  UNLOCK (engine_info_lock);
+  return err;
+}
+
+
+/* Get a deep copy of the engine info list INFO, which is usually the
+ * list of a context, and return it in R_INFO.  Unlike
+ * _gpgme_engine_info_copy this does not touch the global engine info
+ * and thus does not need to take its lock.  */
+gpgme_error_t
+_gpgme_engine_info_dup (gpgme_engine_info_t *r_info, gpgme_engine_info_t info)
+{
+  return engine_info_copy_list (r_info, info);
+}
+
+
 /* Set the engine info for the info list INFO, protocol PROTO, to the
    file name FILE_NAME and the home directory HOME_DIR.  */
 gpgme_error_t
@@ -509,25 +544,23 @@ gpgme_set_engine_info (gpgme_protocol_t proto,
 }
 
 
-gpgme_error_t
-_gpgme_engine_new (gpgme_engine_info_t info, engine_t *r_engine)
+/* Create an engine object using OPS and store it at R_ENGINE.  */
+static gpgme_error_t
+engine_new (struct engine_ops *ops, const char *file_name,
+            const char *home_dir, const char *version, engine_t *r_engine)
 {
   engine_t engine;
 
-  if (!info->file_name || !info->version)
-    return trace_gpg_error (GPG_ERR_INV_ENGINE);
-
   engine = calloc (1, sizeof *engine);
   if (!engine)
     return gpg_error_from_syserror ();
 
-  engine->ops = engine_ops[info->protocol];
+  engine->ops = ops;
   if (engine->ops->new)
     {
       gpgme_error_t err;
       err = (*engine->ops->new) (&engine->engine,
-				 info->file_name, info->home_dir,
-                                 info->version);
+				 file_name, home_dir, version);
       if (err)
 	{
 	  free (engine);
@@ -542,6 +575,27 @@ _gpgme_engine_new (gpgme_engine_info_t info, engine_t *r_engine)
 }
 
 
+gpgme_error_t
+_gpgme_engine_new (gpgme_engine_info_t info, engine_t *r_engine)
+{
+  if (!info->file_name || !info->version)
+    return trace_gpg_error (GPG_ERR_INV_ENGINE);
+
+  return engine_new (engine_ops[info->protocol], info->file_name,
+                     info->home_dir, info->version, r_engine);
+}
+
+
+/* Create a replay engine which answers all operations from the
+ * transcript FILE_NAME instead of running an engine program.  */
+gpgme_error_t
+_gpgme_engine_new_replay (const char *file_name, engine_t *r_engine)
+{
+  return engine_new (&_gpgme_engine_ops_replay, file_name, NULL, NULL,
+                     r_engine);
+}
+
+
 gpgme_error_t
 _gpgme_engine_reset (engine_t engine)
 {
@@ -1051,6 +1105,8 @@ _gpgme_engine_io_event (engine_t engine,
   if (!engine)
     return;
 
+  if (type == GPGME_EVENT_DONE)
+    TRACE_SPAN_ASYNC_END ("operation", engine);
   (*engine->ops->io_event) (engine->engine, type, type_data);
 }
 
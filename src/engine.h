@@ -50,6 +50,11 @@ int _gpgme_set_engine_minimal_version (const char *value);
 /* Get a deep copy of the engine info and return it in INFO.  */
 gpgme_error_t _gpgme_engine_info_copy (gpgme_engine_info_t *r_info);
 
+/* Get a deep copy of the engine info list INFO and return it in
+   R_INFO.  */
+gpgme_error_t _gpgme_engine_info_dup (gpgme_engine_info_t *r_info,
+                                      gpgme_engine_info_t info);
+
 /* Release the engine info INFO.  */
 void _gpgme_engine_info_release (gpgme_engine_info_t info);
 
@@ -63,6 +68,8 @@ gpgme_error_t _gpgme_set_engine_info (gpgme_engine_info_t info,
 
 gpgme_error_t _gpgme_engine_new (gpgme_engine_info_t info,
 				 engine_t *r_engine);
+gpgme_error_t _gpgme_engine_new_replay (const char *file_name,
+                                        engine_t *r_engine);
 gpgme_error_t _gpgme_engine_reset (engine_t engine);
 
 gpgme_error_t _gpgme_engine_set_locale (engine_t engine, int category,
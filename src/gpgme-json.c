@@ -3061,6 +3061,92 @@ leave:
 }
 
 
+
+static const char hlp_batch[] =
+  "op:       \"batch\"\n"
+  "requests: Array of request objects.  Only the operations \"keylist\"\n"
+  "          and \"export\" are allowed.  The \"chunksize\" property of\n"
+  "          the requests is ignored.\n"
+  "\n"
+  "Response on success:\n"
+  "type:      \"batch\"\n"
+  "responses: Array with the response objects of the requests in the\n"
+  "           same order.  A failing request yields an error object\n"
+  "           at its position and does not stop the other requests.";
+static gpg_error_t
+op_batch (cjson_t request, cjson_t result)
+{
+  static struct {
+    const char *op;
+    gpg_error_t (*handler)(cjson_t request, cjson_t result);
+  } batchtbl[] = {
+    { "export",     op_export },
+    { "keylist",    op_keylist },
+    { NULL }
+  };
+  cjson_t j_requests, j_item, j_op, j_tmp;
+  cjson_t j_responses, j_response;
+  gpg_error_t err;
+  int nrequests, i, idx;
+
+  j_requests = cJSON_GetObjectItem (request, "requests");
+  if (!j_requests || !cjson_is_array (j_requests))
+    return gpg_error (GPG_ERR_INV_VALUE);
+
+  /* Check all requests first so that nothing is done for a malformed
+   * batch.  */
+  nrequests = cJSON_GetArraySize (j_requests);
+  for (i=0; i < nrequests; i++)
+    {
+      j_item = cJSON_GetArrayItem (j_requests, i);
+      if (!j_item || !cjson_is_object (j_item))
+        return gpg_error (GPG_ERR_INV_VALUE);
+      j_op = cJSON_GetObjectItem (j_item, "op");
+      if (!j_op || !cjson_is_string (j_op))
+        return gpg_error (GPG_ERR_INV_VALUE);
+      for (idx=0; batchtbl[idx].op; idx++)
+        if (!strcmp (j_op->valuestring, batchtbl[idx].op))
+          break;
+      if (!batchtbl[idx].op)
+        {
+          gpg_error_object (result, gpg_error (GPG_ERR_FORBIDDEN),
+                            "Operation '%s' not allowed in a batch",
+                            j_op->valuestring);
+          return gpg_error (GPG_ERR_FORBIDDEN);
+        }
+    }
+
+  j_responses = xjson_CreateArray ();
+  for (i=0; i < nrequests; i++)
+    {
+      j_item = cJSON_GetArrayItem (j_requests, i);
+      j_op = cJSON_GetObjectItem (j_item, "op");
+      for (idx=0; strcmp (j_op->valuestring, batchtbl[idx].op); idx++)
+        ;
+
+      /* Like the dispatcher, but an error only affects this
+       * response.  */
+      j_response = xjson_CreateObject ();
+      err = batchtbl[idx].handler (j_item, j_response);
+      if (err)
+        {
+          if (!(j_tmp = cJSON_GetObjectItem (j_response, "type"))
+              || !cjson_is_string (j_tmp)
+              || strcmp (j_tmp->valuestring, "error"))
+            gpg_error_object (j_response, err, "Operation failed: %s",
+                              gpg_strerror (err));
+          xjson_AddStringToObject (j_response, "op", j_op->valuestring);
+        }
+      cJSON_AddItemToArray (j_responses, j_response);
+    }
+
+  xjson_AddStringToObject (result, "type", "batch");
+  xjson_AddItemToObject (result, "responses", j_responses);
+
+  return 0;
+}
+
+
 
 static const char hlp_getmore[] =
   "op:     \"getmore\"\n"
@@ -3150,6 +3236,7 @@ static const char hlp_help[] =
   "operation is not performned but a string with the documentation\n"
   "returned.  To list all operations it is allowed to leave out \"op\" in\n"
   "help mode.  Supported values for \"op\" are:\n\n"
+  "  batch       Run several keylist and export requests.\n"
   "  config      Read configuration values.\n"
   "  config_opt  Read a single configuration value.\n"
   "  decrypt     Decrypt data.\n"
@@ -3207,6 +3294,7 @@ process_request (const char *request)
     gpg_error_t (*handler)(cjson_t request, cjson_t result);
     const char * const helpstr;
   } optbl[] = {
+    { "batch",      op_batch,      hlp_batch },
     { "config",     op_config,     hlp_config },
     { "config_opt", op_config_opt, hlp_config_opt },
     { "encrypt",    op_encrypt,    hlp_encrypt },
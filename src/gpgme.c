@@ -68,6 +68,8 @@ gpgme_set_global_flag (const char *name, const char *value)
     return -1;
   else if (!strcmp (name, "debug"))
     return _gpgme_debug_set_debug_envvar (value);
+  else if (!strcmp (name, "spans"))
+    return _gpgme_debug_set_spans_envvar (value);
   else if (!strcmp (name, "disable-gpgconf"))
     {
       _gpgme_dirinfo_disable_gpgconf ();
@@ -81,6 +83,8 @@ gpgme_set_global_flag (const char *name, const char *value)
     return _gpgme_set_default_gpg_name (value);
   else if (!strcmp (name, "w32-inst-dir"))
     return _gpgme_set_override_inst_dir (value);
+  else if (!strcmp (name, "version-cache"))
+    return _gpgme_set_version_cache_file (value);
   else
     return -1;
 }
@@ -230,6 +234,21 @@ gpgme_cancel_async (gpgme_ctx_t ctx)
 }
 
 
+/* Return the statistics of the current or last operation of CTX.  */
+gpgme_op_stats_t
+gpgme_op_stats (gpgme_ctx_t ctx)
+{
+  TRACE (DEBUG_CTX, "gpgme_op_stats", ctx, "");
+
+  if (!ctx)
+    return NULL;
+
+  if (!ctx->stats_done && ctx->stats_start)
+    ctx->stats.total_usec = _gpgme_get_usec () - ctx->stats_start;
+  return &ctx->stats;
+}
+
+
 /* Release all resources associated with the given context.  */
 void
 gpgme_release (gpgme_ctx_t ctx)
@@ -253,6 +272,8 @@ gpgme_release (gpgme_ctx_t ctx)
   free (ctx->request_origin);
   free (ctx->auto_key_locate);
   free (ctx->trust_model);
+  free (ctx->replay_file);
+  free (ctx->replay_pace);
   _gpgme_engine_info_release (ctx->engine_info);
   ctx->engine_info = NULL;
   DESTROY_LOCK (ctx->lock);
@@ -493,6 +514,20 @@ gpgme_get_armor (gpgme_ctx_t ctx)
 }
 
 
+/* Return true if an operation is running on CTX, that is if file
+ * descriptors of its engine are still registered.  */
+static int
+op_is_active (gpgme_ctx_t ctx)
+{
+  size_t i;
+
+  for (i = 0; i < ctx->fdt.size; i++)
+    if (ctx->fdt.fds[i].fd != -1)
+      return 1;
+  return 0;
+}
+
+
 /* Set the flag NAME for CTX to VALUE.  Please consult the manual for
  * a description of the flags.
  */
@@ -566,6 +601,50 @@ gpgme_set_ctx_flag (gpgme_ctx_t ctx, const char *name, const char *value)
       if (!ctx->trust_model)
         err = gpg_error_from_syserror ();
     }
+  else if (!strcmp (name, "replay"))
+    {
+      /* Switching the engine would pull it away under the I/O
+       * callbacks of a running operation.  */
+      if (op_is_active (ctx))
+        return gpg_error (GPG_ERR_EBUSY);
+      free (ctx->replay_file);
+      ctx->replay_file = NULL;
+      if (*value)
+        {
+          ctx->replay_file = strdup (value);
+          if (!ctx->replay_file)
+            err = gpg_error_from_syserror ();
+        }
+      /* The next operation shall use the new engine.  */
+      _gpgme_engine_release (ctx->engine);
+      ctx->engine = NULL;
+    }
+  else if (!strcmp (name, "replay-pace"))
+    {
+      unsigned long latency = 0, rate = 0;
+      char *endp = (char *)value;
+
+      if (*value)
+        {
+          latency = strtoul (value, &endp, 10);
+          if (*endp == ',')
+            rate = strtoul (endp + 1, &endp, 10);
+        }
+      if (*endp)
+        err = gpg_error (GPG_ERR_INV_VALUE);
+      else
+        {
+          free (ctx->replay_pace);
+          ctx->replay_pace = *value? strdup (value) : NULL;
+          if (*value && !ctx->replay_pace)
+            err = gpg_error_from_syserror ();
+          else
+            {
+              ctx->replay_latency = latency;
+              ctx->replay_rate = rate;
+            }
+        }
+    }
   else
     err = gpg_error (GPG_ERR_UNKNOWN_NAME);
 
@@ -623,6 +702,14 @@ gpgme_get_ctx_flag (gpgme_ctx_t ctx, const char *name)
     {
       return ctx->auto_key_locate? ctx->auto_key_locate : "";
     }
+  else if (!strcmp (name, "replay"))
+    {
+      return ctx->replay_file? ctx->replay_file : "";
+    }
+  else if (!strcmp (name, "replay-pace"))
+    {
+      return ctx->replay_pace? ctx->replay_pace : "";
+    }
   else
     return NULL;
 }
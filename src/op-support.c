@@ -32,6 +32,7 @@
 #include "context.h"
 #include "ops.h"
 #include "util.h"
+#include "priv-io.h"
 #include "debug.h"
 
 #if GPG_ERROR_VERSION_NUMBER < 0x011700  /* 1.23 */
@@ -98,6 +99,11 @@ _gpgme_op_reset (gpgme_ctx_t ctx, int type)
   ctx->redraw_suggested = 0;
   UNLOCK (ctx->lock);
 
+  memset (&ctx->stats, 0, sizeof ctx->stats);
+  ctx->stats_done = 0;
+  ctx->stats_start = _gpgme_get_usec ();
+  _gpgme_io_spawn_stats (&ctx->stats_spawns, &ctx->stats_spawn_usec);
+
   if (ctx->engine && no_reset)
     reuse_engine = 1;
   else if (ctx->engine)
@@ -112,7 +118,13 @@ _gpgme_op_reset (gpgme_ctx_t ctx, int type)
 	}
     }
 
-  if (!ctx->engine)
+  if (!ctx->engine && ctx->replay_file)
+    {
+      err = _gpgme_engine_new_replay (ctx->replay_file, &ctx->engine);
+      if (err)
+	return err;
+    }
+  else if (!ctx->engine)
     {
       gpgme_engine_info_t info;
       info = ctx->engine_info;
@@ -201,10 +213,38 @@ _gpgme_op_reset (gpgme_ctx_t ctx, int type)
       io_cbs.event_priv = ctx;
     }
   _gpgme_engine_set_io_cbs (ctx->engine, &io_cbs);
+  TRACE_SPAN_ASYNC_BEGIN ("operation", ctx->engine);
   return err;
 }
 
 
+/* Called with the GPGME_EVENT_START event.  The engine has been
+   started in this thread after _gpgme_op_reset and thus the spawns
+   since then are those of the operation.  */
+void
+_gpgme_op_stats_started (gpgme_ctx_t ctx)
+{
+  unsigned long spawns;
+  unsigned long long spawn_usec;
+
+  _gpgme_io_spawn_stats (&spawns, &spawn_usec);
+  ctx->stats.spawns = spawns - ctx->stats_spawns;
+  ctx->stats.spawn_usec = spawn_usec - ctx->stats_spawn_usec;
+}
+
+
+/* Called with the GPGME_EVENT_DONE event.  */
+void
+_gpgme_op_stats_done (gpgme_ctx_t ctx)
+{
+  if (!ctx->stats_done)
+    {
+      ctx->stats.total_usec = _gpgme_get_usec () - ctx->stats_start;
+      ctx->stats_done = 1;
+    }
+}
+
+
 /* Parse the INV_RECP or INV_SNDR status line in ARGS and return the
    result in KEY.  If KC_FPR (from the KEY_CONSIDERED status line) is
    not NULL take the KC_FLAGS in account. */
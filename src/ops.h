@@ -57,6 +57,11 @@ gpgme_error_t _gpgme_op_data_lookup (gpgme_ctx_t ctx, ctx_op_data_id_t type,
 /* Prepare a new operation on CTX.  */
 gpgme_error_t _gpgme_op_reset (gpgme_ctx_t ctx, int synchronous);
 
+/* Update the statistics of CTX for the start and the end of the
+   operation.  */
+void _gpgme_op_stats_started (gpgme_ctx_t ctx);
+void _gpgme_op_stats_done (gpgme_ctx_t ctx);
+
 /* Parse the KEY_CONSIDERED status line.  */
 gpgme_error_t _gpgme_parse_key_considered (const char *args,
                                            char **r_fpr, unsigned int *r_flags);
@@ -171,6 +176,9 @@ void _gpgme_op_trustlist_event_cb (void *data, gpgme_event_io_t type,
 int _gpgme_compare_versions (const char *my_version,
 			     const char *req_version);
 char *_gpgme_get_program_version (const char *const path);
+void _gpgme_prefetch_program_versions (const char *const *file_names,
+                                       int n);
+int _gpgme_set_version_cache_file (const char *value);
 
 
 /* From sig-notation.c.  */
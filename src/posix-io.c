@@ -54,6 +54,24 @@
 # include <dirent.h>
 #endif /*USE_LINUX_GETDENTS*/
 
+#ifdef __linux__
+# include <sys/syscall.h>
+# ifdef SYS_close_range
+#  define USE_LINUX_CLOSE_RANGE 1
+#  ifndef CLOSE_RANGE_CLOEXEC
+#   define CLOSE_RANGE_CLOEXEC (1U << 2)
+#  endif
+# endif
+#endif /*__linux__*/
+
+/* posix_spawn can only be used if it is able to close all fds not
+ * inherited by the child.  */
+#ifdef HAVE_POSIX_SPAWN_FILE_ACTIONS_ADDCLOSEFROM_NP
+# include <spawn.h>
+# define USE_POSIX_SPAWN 1
+extern char **environ;
+#endif
+
 
 #include "util.h"
 #include "priv-io.h"
@@ -433,6 +451,57 @@ get_max_fds (void)
 }
 
 
+/* Close the file descriptors FIRST to LAST in a child process before
+ * exec.  If LAST is -1 all descriptors from FIRST on are closed.
+ * *MAX_FDS caches the result of get_max_fds; it is initialized by the
+ * caller to -1.  Only async-signal-safe functions may be used here.
+ *
+ * With Linux' close_range the descriptors are merely marked
+ * close-on-exec, which avoids tearing down the files in the child
+ * just before exec does the same.  */
+static void
+close_fd_range (int first, int last, int *max_fds)
+{
+  int fd;
+
+#ifdef USE_LINUX_CLOSE_RANGE
+  {
+    unsigned int ulast = last == -1? ~0U : (unsigned int)last;
+
+    /* CLOSE_RANGE_CLOEXEC requires Linux 5.11.  */
+    if (!syscall (SYS_close_range, first, ulast, CLOSE_RANGE_CLOEXEC)
+        || !syscall (SYS_close_range, first, ulast, 0))
+      return;
+  }
+#endif /*USE_LINUX_CLOSE_RANGE*/
+
+  if (last == -1)
+    {
+      /* Note that the closefrom of Solaris, FreeBSD and glibc does
+       * not return errors.  */
+#ifdef HAVE_CLOSEFROM
+# if defined(__sun) || defined(__FreeBSD__) || defined(__GLIBC__)
+      closefrom (first);
+      return;
+# else
+      int rc;
+
+      while ((rc = closefrom (first)) && errno == EINTR)
+        ;
+      if (!rc || errno == EBADF)
+        return;
+# endif
+#endif /*HAVE_CLOSEFROM*/
+      if (*max_fds == -1)
+        *max_fds = get_max_fds ();
+      last = *max_fds - 1;
+    }
+
+  for (fd = first; fd <= last; fd++)
+    close (fd);
+}
+
+
 int
 _gpgme_io_waitpid (int pid, int hang, int *r_status, int *r_signal)
 {
@@ -462,6 +531,134 @@ _gpgme_io_waitpid (int pid, int hang, int *r_status, int *r_signal)
 }
 
 
+void
+_gpgme_io_spawn_wait (pid_t pid)
+{
+  int status;
+  int signo;
+
+  if (pid == -1)
+    return;
+  TRACE (DEBUG_SYSIO, "_gpgme_io_spawn_wait", NULL, "pid=%i", (int)pid);
+  _gpgme_io_waitpid (pid, 1, &status, &signo);
+}
+
+
+#ifdef USE_POSIX_SPAWN
+/* Spawn PATH using posix_spawn.  The file actions mirror what the
+ * forked child in _gpgme_io_spawn does.  KEEP is the sorted list of
+ * the NKEEP fds from FD_LIST.  On success the pid is stored at R_PID.
+ * Returns 0 on success or -1 with ERRNO set.  */
+static int
+spawn_with_posix_spawn (const char *path, char *const argv[],
+                        struct spawn_fd_item_s *fd_list,
+                        const int *keep, int nkeep, pid_t *r_pid)
+{
+  posix_spawn_file_actions_t actions;
+  int seen[3] = { 0, 0, 0 };
+  pid_t pid;
+  int fd;
+  int i;
+  int rc;
+
+  rc = posix_spawn_file_actions_init (&actions);
+  if (rc)
+    {
+      errno = rc;
+      return -1;
+    }
+
+  /* Close all fds which will not be inherited.  Closing an fd which
+   * is not open is not an error for posix_spawn.  */
+  fd = 0;
+  for (i = 0; !rc && i < nkeep; i++)
+    {
+      for (; !rc && fd < keep[i]; fd++)
+        rc = posix_spawn_file_actions_addclose (&actions, fd);
+      fd = keep[i] + 1;
+    }
+  if (!rc)
+    rc = posix_spawn_file_actions_addclosefrom_np (&actions, fd);
+
+  /* And now dup and close those to be duplicated.  */
+  for (i = 0; !rc && fd_list[i].fd != -1; i++)
+    {
+      int child_fd;
+
+      if (fd_list[i].dup_to != -1)
+        child_fd = fd_list[i].dup_to;
+      else
+        child_fd = fd_list[i].fd;
+      if (child_fd >= 0 && child_fd <= 2)
+        seen[child_fd] = 1;
+
+      if (fd_list[i].dup_to == -1 || fd_list[i].dup_to == fd_list[i].fd)
+        continue;
+
+      rc = posix_spawn_file_actions_adddup2 (&actions, fd_list[i].fd,
+                                             fd_list[i].dup_to);
+      if (!rc)
+        rc = posix_spawn_file_actions_addclose (&actions, fd_list[i].fd);
+    }
+
+  /* Make sure that the process has connected stdin, stdout and
+   * stderr.  */
+  for (fd = 0; !rc && fd <= 2; fd++)
+    if (!seen[fd])
+      rc = posix_spawn_file_actions_addopen (&actions, fd, "/dev/null",
+                                             O_RDWR, 0);
+
+  if (!rc)
+    rc = posix_spawn (&pid, path, &actions, NULL, argv, environ);
+
+  posix_spawn_file_actions_destroy (&actions);
+  if (rc)
+    {
+      errno = rc;
+      return -1;
+    }
+
+  *r_pid = pid;
+  return 0;
+}
+#endif /*USE_POSIX_SPAWN*/
+
+
+#ifdef HAVE_TLS
+/* The number of processes spawned by the current thread and the time
+ * spent doing so.  */
+static __thread unsigned long spawn_count;
+static __thread unsigned long long spawn_usec;
+#endif
+
+
+/* Account for a spawn of PATH which started at STARTED.  */
+static void
+spawn_finished (const char *path, unsigned long long started)
+{
+  TRACE_SPAN_END ("spawn", path);
+#ifdef HAVE_TLS
+  spawn_count++;
+  spawn_usec += _gpgme_get_usec () - started;
+#else
+  (void)started;
+#endif
+}
+
+
+void
+_gpgme_io_spawn_stats (unsigned long *r_count, unsigned long long *r_usec)
+{
+#ifdef HAVE_TLS
+  *r_count = spawn_count;
+  *r_usec = spawn_usec;
+#else
+  *r_count = 0;
+  *r_usec = 0;
+#endif
+}
+
+
 /* Returns 0 on success, -1 on error.  */
 int
 _gpgme_io_spawn (const char *path, char *const argv[], unsigned int flags,
@@ -469,10 +666,13 @@ _gpgme_io_spawn (const char *path, char *const argv[], unsigned int flags,
 		 void (*atfork) (void *opaque, int reserved),
 		 void *atforkvalue, pid_t *r_pid)
 {
-  pid_t pid;
+  pid_t pid = -1;
   int i;
   int status;
   int signo;
+  int *keep;
+  int nkeep;
+  unsigned long long started;
 
   TRACE_BEG  (DEBUG_SYSIO, "_gpgme_io_spawn", path,
 	      "path=%s", path);
@@ -488,14 +688,54 @@ _gpgme_io_spawn (const char *path, char *const argv[], unsigned int flags,
     else
       TRACE_LOG  ("fd[%i] = 0x%x -> 0x%x", i, fd_list[i].fd, fd_list[i].dup_to);
 
+  /* Prepare the sorted list of fds to be inherited.  This needs to be
+   * done before the fork because the child may not allocate memory.  */
+  keep = malloc ((i + 1) * sizeof *keep);
+  if (!keep)
+    return TRACE_SYSRES (-1);
+  for (nkeep = 0; fd_list[nkeep].fd != -1; nkeep++)
+    {
+      int fd = fd_list[nkeep].fd;
+      int j;
+
+      for (j = nkeep; j > 0 && keep[j - 1] > fd; j--)
+        keep[j] = keep[j - 1];
+      keep[j] = fd;
+    }
+
+  TRACE_SPAN_BEGIN ("spawn", path);
+  started = _gpgme_get_usec ();
+
+#ifdef USE_POSIX_SPAWN
+  /* posix_spawn avoids copying the page tables of the process, which
+   * is costly for large processes.  It can't run ATFORK in the
+   * child, though, and the process is our child.  It is thus only
+   * used if the caller waits for the process.  */
+  if (!atfork && (flags & IOSPAWN_FLAG_WAIT))
+    {
+      status = spawn_with_posix_spawn (path, argv, fd_list, keep, nkeep,
+                                       &pid);
+      free (keep);
+      spawn_finished (path, started);
+      if (status)
+        return TRACE_SYSRES (-1);
+      goto leave;
+    }
+#endif /*USE_POSIX_SPAWN*/
+
   pid = fork ();
   if (pid == -1)
-    return TRACE_SYSRES (-1);
+    {
+      free (keep);
+      spawn_finished (path, started);
+      return TRACE_SYSRES (-1);
+    }
 
   if (!pid)
     {
-      /* Intermediate child to prevent zombie processes.  */
-      if ((pid = fork ()) == 0)
+      /* Intermediate child to prevent zombie processes.  It is not
+       * needed if the caller waits for the process.  */
+      if ((flags & IOSPAWN_FLAG_WAIT) || (pid = fork ()) == 0)
 	{
 	  /* Child.  */
           int max_fds = -1;
@@ -507,40 +747,16 @@ _gpgme_io_spawn (const char *path, char *const argv[], unsigned int flags,
 	  if (atfork)
 	    atfork (atforkvalue, 0);
 
-          /* First close all fds which will not be inherited.  If we
-           * have closefrom(2) we first figure out the highest fd we
-           * do not want to close, then call closefrom, and on success
-           * use the regular code to close all fds up to the start
-           * point of closefrom.  Note that Solaris' and FreeBSD's closefrom do
-           * not return errors.  */
-#ifdef HAVE_CLOSEFROM
-          {
-            fd = -1;
-            for (i = 0; fd_list[i].fd != -1; i++)
-              if (fd_list[i].fd > fd)
-                fd = fd_list[i].fd;
-            fd++;
-#if defined(__sun) || defined(__FreeBSD__)
-            closefrom (fd);
-            max_fds = fd;
-#else /*!__sun */
-            while ((i = closefrom (fd)) && errno == EINTR)
-              ;
-            if (!i || errno == EBADF)
-              max_fds = fd;
-#endif /*!__sun*/
-          }
-#endif /*HAVE_CLOSEFROM*/
-          if (max_fds == -1)
-            max_fds = get_max_fds ();
-          for (fd = 0; fd < max_fds; fd++)
+          /* First close all fds which will not be inherited.  KEEP
+           * is sorted, so we close the gaps between its entries.  */
+          fd = 0;
+          for (i = 0; i < nkeep; i++)
             {
-              for (i = 0; fd_list[i].fd != -1; i++)
-                if (fd_list[i].fd == fd)
-                  break;
-              if (fd_list[i].fd == -1)
-                close (fd);
+              if (keep[i] > fd)
+                close_fd_range (fd, keep[i] - 1, &max_fds);
+              fd = keep[i] + 1;
             }
+          close_fd_range (fd, -1, &max_fds);
 
 	  /* And now dup and close those to be duplicated.  */
 	  for (i = 0; fd_list[i].fd != -1; i++)
@@ -619,11 +835,22 @@ _gpgme_io_spawn (const char *path, char *const argv[], unsigned int flags,
 	_exit (0);
     }
 
-  TRACE_LOG  ("waiting for child process pid=%i", pid);
-  _gpgme_io_waitpid (pid, 1, &status, &signo);
-  if (status)
-    return TRACE_SYSRES (-1);
+  free (keep);
+  if (!(flags & IOSPAWN_FLAG_WAIT))
+    {
+      TRACE_LOG  ("waiting for child process pid=%i", pid);
+      _gpgme_io_waitpid (pid, 1, &status, &signo);
+      if (status)
+        {
+          spawn_finished (path, started);
+          return TRACE_SYSRES (-1);
+        }
+    }
+  spawn_finished (path, started);
 
+#ifdef USE_POSIX_SPAWN
+ leave:
+#endif
   for (i = 0; fd_list[i].fd != -1; i++)
     {
       if (! (flags & IOSPAWN_FLAG_NOCLOSE))
@@ -26,6 +26,10 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <time.h>
+#ifdef HAVE_SYS_TIME_H
+# include <sys/time.h>
+#endif
 
 #include "util.h"
 #include "sys-util.h"
@@ -157,3 +161,22 @@ _gpgme_allow_set_foreground_window (pid_t pid)
   (void)pid;
   /* Not needed.  */
 }
+
+
+/* Return a monotonic time in microseconds.  */
+unsigned long long
+_gpgme_get_usec (void)
+{
+#ifdef CLOCK_MONOTONIC
+  struct timespec tp;
+
+  if (!clock_gettime (CLOCK_MONOTONIC, &tp))
+    return (unsigned long long)tp.tv_sec * 1000000 + tp.tv_nsec / 1000;
+#endif
+  {
+    struct timeval tv;
+
+    gettimeofday (&tv, NULL);
+    return (unsigned long long)tv.tv_sec * 1000000 + tv.tv_usec;
+  }
+}
@@ -82,6 +82,10 @@ int _gpgme_io_set_nonblocking (int fd);
 #define IOSPAWN_FLAG_NOCLOSE 4
 /* Set show window to true for windows */
 #define IOSPAWN_FLAG_SHOW_WINDOW 8
+/* Under POSIX, do not detach the process.  The caller must wait for
+   it with _gpgme_io_spawn_wait once it has closed all pipes to the
+   process.  */
+#define IOSPAWN_FLAG_WAIT 16
 
 /* Spawn the executable PATH with ARGV as arguments.  After forking
    close all fds except for those in FD_LIST in the child, then
@@ -92,8 +96,16 @@ int _gpgme_io_spawn (const char *path, char *const argv[], unsigned int flags,
 		     void (*atfork) (void *opaque, int reserved),
 		     void *atforkvalue, pid_t *r_pid);
 
+/* Wait for the process PID spawned with IOSPAWN_FLAG_WAIT to
+   terminate.  Does nothing if PID is -1.  */
+void _gpgme_io_spawn_wait (pid_t pid);
+
 int _gpgme_io_select (struct io_select_fd_s *fds, size_t nfds, int nonblock);
 
+/* Store the number of processes spawned by the current thread and
+   the time in microseconds spent doing so at R_COUNT and R_USEC.  */
+void _gpgme_io_spawn_stats (unsigned long *r_count, unsigned long long *r_usec);
+
 /* Write the printable version of FD to the buffer BUF of length
    BUFLEN.  The printable version is the representation on the command
    line that the child process expects.  */
@@ -55,6 +55,7 @@
 /*-- {posix,w32}-util.c --*/
 int _gpgme_get_conf_int (const char *key, int *value);
 void _gpgme_allow_set_foreground_window (pid_t pid);
+unsigned long long _gpgme_get_usec (void);
 
 /*-- dirinfo.c --*/
 void _gpgme_dirinfo_disable_gpgconf (void);
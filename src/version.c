@@ -22,10 +22,20 @@
 #if HAVE_CONFIG_H
 #include <config.h>
 #endif
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
 #include <ctype.h>
+#ifdef HAVE_SYS_TYPES_H
+# include <sys/types.h>
+#endif
+#ifdef HAVE_SYS_STAT_H
+# include <sys/stat.h>
+#endif
+#ifdef HAVE_UNISTD_H
+# include <unistd.h>
+#endif
 #ifdef HAVE_W32_SYSTEM
 #include <winsock2.h>
 #endif
@@ -296,42 +306,262 @@ extract_version_string (const char *string, size_t *r_len)
 }
 
 
-/* Retrieve the version number from the --version output of the
-   program FILE_NAME.  */
-char *
-_gpgme_get_program_version (const char *const file_name)
+/* The identity of a program binary.  If any of these values changes
+   the binary has been replaced and a cached version is stale.  */
+struct program_id_s
+{
+  unsigned long long dev;
+  unsigned long long ino;
+  long long mtime;
+  long long size;
+};
+
+/* An entry of the version cache.  */
+struct version_cache_item_s
+{
+  struct version_cache_item_s *next;
+  struct program_id_s id;
+  char *version;
+  char file_name[1];
+};
+
+/* Cache of program versions, so that the engines need to be spawned
+   only once per process or, with a cache file, only once per
+   installed version.  */
+static struct version_cache_item_s *version_cache;
+/* If not NULL the file used to store the cache across processes.  */
+static char *version_cache_file;
+/* True if the cache file has been read.  */
+static int version_cache_loaded;
+DEFINE_STATIC_LOCK (version_cache_lock);
+
+
+/* This is an internal function to set the name of the version cache
+ * file.  This function must only be called by gpgme_set_global_flag.
+ * Returns 0 on success.  */
+int
+_gpgme_set_version_cache_file (const char *value)
+{
+  free (version_cache_file);
+  version_cache_file = NULL;
+  version_cache_loaded = 0;
+  if (value && *value)
+    {
+      version_cache_file = strdup (value);
+      return !version_cache_file;
+    }
+  return 0;
+}
+
+
+/* Store the identity of the program FILE_NAME at ID.  Returns 0 on
+   success.  */
+static int
+get_program_id (const char *file_name, struct program_id_s *id)
+{
+  struct stat st;
+
+  if (!file_name || stat (file_name, &st))
+    return -1;
+  id->dev = st.st_dev;
+  id->ino = st.st_ino;
+  id->mtime = st.st_mtime;
+  id->size = st.st_size;
+  return 0;
+}
+
+
+/* Return the cache item for FILE_NAME with identity ID or NULL.
+   VERSION_CACHE_LOCK must be held by the caller.  */
+static struct version_cache_item_s *
+version_cache_find (const char *file_name, const struct program_id_s *id)
+{
+  struct version_cache_item_s *item;
+
+  for (item = version_cache; item; item = item->next)
+    if (!strcmp (item->file_name, file_name)
+        && !memcmp (&item->id, id, sizeof *id))
+      return item;
+  return NULL;
+}
+
+
+/* Add VERSION for FILE_NAME with identity ID to the cache, replacing
+   a stale entry.  Returns true if the cache has been changed.
+   VERSION_CACHE_LOCK must be held by the caller.  */
+static int
+version_cache_put (const char *file_name, const struct program_id_s *id,
+                   const char *version)
+{
+  struct version_cache_item_s *item, **itemp;
+
+  for (itemp = &version_cache; *itemp; itemp = &(*itemp)->next)
+    if (!strcmp ((*itemp)->file_name, file_name))
+      {
+        item = *itemp;
+        if (!memcmp (&item->id, id, sizeof *id)
+            && !strcmp (item->version, version))
+          return 0;
+        *itemp = item->next;
+        free (item->version);
+        free (item);
+        break;
+      }
+
+  item = malloc (sizeof *item + strlen (file_name));
+  if (!item)
+    return 0;
+  item->version = strdup (version);
+  if (!item->version)
+    {
+      free (item);
+      return 0;
+    }
+  item->id = *id;
+  strcpy (item->file_name, file_name);
+  item->next = version_cache;
+  version_cache = item;
+  return 1;
+}
+
+
+/* Read the cache file if it has not yet been read.  Each line of the
+   file has the device and inode numbers, the modification time and
+   the size of the binary followed by its version and its file name,
+   which extends to the end of the line.  Malformed lines are
+   ignored.  VERSION_CACHE_LOCK must be held by the caller.  */
+static void
+version_cache_load (void)
+{
+  FILE *fp;
+  char line[1024];
+  char version[64];
+  struct program_id_s id;
+  int n;
+  char *p;
+
+  if (version_cache_loaded || !version_cache_file)
+    return;
+  version_cache_loaded = 1;
+
+  fp = fopen (version_cache_file, "r");
+  if (!fp)
+    return;
+  while (fgets (line, sizeof line, fp))
+    {
+      p = strchr (line, '\n');
+      if (!p)
+        break;  /* Line too long or truncated file.  */
+      *p = 0;
+      n = 0;
+      if (sscanf (line, "%llu %llu %lld %lld %63s %n",
+                  &id.dev, &id.ino, &id.mtime, &id.size, version, &n) < 5
+          || !n || !line[n])
+        continue;
+      version_cache_put (line + n, &id, version);
+    }
+  fclose (fp);
+  TRACE (DEBUG_INIT, "gpgme:version_cache_load", 0,
+         "read '%s'", version_cache_file);
+}
+
+
+/* Write the cache to the cache file.  The file is replaced
+   atomically so that concurrent readers never see a partial file.
+   VERSION_CACHE_LOCK must be held by the caller.  */
+static void
+version_cache_save (void)
+{
+  struct version_cache_item_s *item;
+  char *tmpname;
+  char suffix[30];
+  FILE *fp;
+  int okay;
+
+  if (!version_cache_file)
+    return;
+
+  snprintf (suffix, sizeof suffix, ".%lu.tmp", (unsigned long)getpid ());
+  tmpname = _gpgme_strconcat (version_cache_file, suffix, NULL);
+  if (!tmpname)
+    return;
+
+  fp = fopen (tmpname, "w");
+  if (!fp)
+    {
+      free (tmpname);
+      return;
+    }
+  for (item = version_cache; item; item = item->next)
+    if (!strchr (item->file_name, '\n'))
+      fprintf (fp, "%llu %llu %lld %lld %s %s\n",
+               item->id.dev, item->id.ino, item->id.mtime, item->id.size,
+               item->version, item->file_name);
+  okay = !ferror (fp);
+  if (fclose (fp))
+    okay = 0;
+#ifdef HAVE_W32_SYSTEM
+  if (okay)
+    remove (version_cache_file);
+#endif
+  if (!okay || rename (tmpname, version_cache_file))
+    remove (tmpname);
+  free (tmpname);
+}
+
+
+/* Spawn FILE_NAME with --version, store its pid at R_PID and return
+   the file descriptor to read its output from, or -1 on error.  */
+static int
+program_version_start (const char *file_name, pid_t *r_pid)
 {
-  char line[LINELENGTH] = "";
-  int linelen = 0;
-  char *mark = NULL;
   int rp[2];
-  int nread;
   char *argv[] = {NULL /* file_name */, (char*)"--version", 0};
   struct spawn_fd_item_s cfd[] = { {-1, 1 /* STDOUT_FILENO */, -1, 0},
 				   {-1, -1} };
   int status;
 
+  *r_pid = -1;
   if (!file_name)
-    return NULL;
+    return -1;
   argv[0] = (char *) file_name;
 
   if (_gpgme_io_pipe (rp, 1) < 0)
-    return NULL;
+    return -1;
 
   cfd[0].fd = rp[1];
 
   status = _gpgme_io_spawn (file_name, argv,
-                            IOSPAWN_FLAG_DETACHED, cfd, NULL, NULL, NULL);
+                            IOSPAWN_FLAG_DETACHED | IOSPAWN_FLAG_WAIT,
+                            cfd, NULL, NULL, r_pid);
   if (status < 0)
     {
       _gpgme_io_close (rp[0]);
       _gpgme_io_close (rp[1]);
-      return NULL;
+      return -1;
     }
 
+  return rp[0];
+}
+
+
+/* Read the output of the program PID started by program_version_start
+   from FD, close FD, wait for the program and return the malloced
+   version number.  */
+static char *
+program_version_finish (int fd, pid_t pid)
+{
+  char line[LINELENGTH] = "";
+  int linelen = 0;
+  char *mark = NULL;
+  int nread;
+
+  if (fd == -1)
+    return NULL;
+
   do
     {
-      nread = _gpgme_io_read (rp[0], &line[linelen], LINELENGTH - linelen - 1);
+      nread = _gpgme_io_read (fd, &line[linelen], LINELENGTH - linelen - 1);
       if (nread > 0)
 	{
 	  line[linelen + nread] = '\0';
@@ -348,7 +578,8 @@ _gpgme_get_program_version (const char *const file_name)
     }
   while (nread > 0 && linelen < LINELENGTH - 1);
 
-  _gpgme_io_close (rp[0]);
+  _gpgme_io_close (fd);
+  _gpgme_io_spawn_wait (pid);
 
   if (mark)
     {
@@ -368,3 +599,97 @@ _gpgme_get_program_version (const char *const file_name)
 
   return NULL;
 }
+
+
+/* Retrieve the version number from the --version output of the
+   program FILE_NAME.  The result is cached as long as the binary does
+   not change.  */
+char *
+_gpgme_get_program_version (const char *const file_name)
+{
+  struct program_id_s id;
+  struct version_cache_item_s *item;
+  char *version = NULL;
+  int have_id;
+  pid_t pid;
+  int fd;
+
+  if (!file_name)
+    return NULL;
+
+  have_id = !get_program_id (file_name, &id);
+  if (have_id)
+    {
+      LOCK (version_cache_lock);
+      version_cache_load ();
+      item = version_cache_find (file_name, &id);
+      if (item)
+        version = strdup (item->version);
+      UNLOCK (version_cache_lock);
+      if (version)
+        return version;
+    }
+
+  fd = program_version_start (file_name, &pid);
+  version = program_version_finish (fd, pid);
+
+  if (version && have_id)
+    {
+      LOCK (version_cache_lock);
+      if (version_cache_put (file_name, &id, version))
+        version_cache_save ();
+      UNLOCK (version_cache_lock);
+    }
+
+  return version;
+}
+
+
+/* Make sure that the versions of the programs in FILE_NAMES, an array
+   with N entries, are in the cache.  All programs whose version is not
+   yet known are spawned before the output of any of them is read, so
+   that they start up concurrently.  */
+void
+_gpgme_prefetch_program_versions (const char *const *file_names, int n)
+{
+  struct program_id_s ids[8];
+  int fds[8];
+  pid_t pids[8];
+  char *version;
+  int changed = 0;
+  int i;
+
+  if (n > (int)DIM (fds))
+    n = DIM (fds);
+
+  LOCK (version_cache_lock);
+  version_cache_load ();
+  for (i = 0; i < n; i++)
+    {
+      fds[i] = -1;
+      if (file_names[i] && !get_program_id (file_names[i], &ids[i])
+          && !version_cache_find (file_names[i], &ids[i]))
+        fds[i] = program_version_start (file_names[i], &pids[i]);
+    }
+  UNLOCK (version_cache_lock);
+
+  for (i = 0; i < n; i++)
+    {
+      if (fds[i] == -1)
+        continue;
+      version = program_version_finish (fds[i], pids[i]);
+      if (!version)
+        continue;
+      LOCK (version_cache_lock);
+      changed |= version_cache_put (file_names[i], &ids[i], version);
+      UNLOCK (version_cache_lock);
+      free (version);
+    }
+
+  if (changed)
+    {
+      LOCK (version_cache_lock);
+      version_cache_save ();
+      UNLOCK (version_cache_lock);
+    }
+}
@@ -804,6 +804,23 @@ _gpgme_io_spawn (const char *path, char * const argv[], unsigned int flags,
 }
 
 
+/* Processes are not reaped on Windows.  */
+void
+_gpgme_io_spawn_wait (pid_t pid)
+{
+  (void)pid;
+}
+
+
+/* The spawn statistics are not yet collected on Windows.  */
+void
+_gpgme_io_spawn_stats (unsigned long *r_count, unsigned long long *r_usec)
+{
+  *r_count = 0;
+  *r_usec = 0;
+}
+
+
 /* Select on the list of fds.  Returns: -1 = error, 0 = timeout or
    nothing to select, > 0 = number of signaled fds.  */
 int
@@ -239,6 +239,19 @@ _gpgme_allow_set_foreground_window (pid_t pid)
 }
 
 
+/* Return a monotonic time in microseconds.  */
+unsigned long long
+_gpgme_get_usec (void)
+{
+  LARGE_INTEGER freq, count;
+
+  if (QueryPerformanceFrequency (&freq) && QueryPerformanceCounter (&count))
+    return ((unsigned long long)(count.QuadPart / freq.QuadPart) * 1000000
+            + (count.QuadPart % freq.QuadPart) * 1000000 / freq.QuadPart);
+  return (unsigned long long)GetTickCount () * 1000;
+}
+
+
 /* Wrapper around CancelSynchronousIo which is only available since
  * Vista.  */
 void
@@ -203,8 +203,10 @@ _gpgme_wait_global_event_cb (void *data, gpgme_event_io_t type,
     {
     case GPGME_EVENT_START:
       {
-	gpgme_error_t err = ctx_active (ctx);
+	gpgme_error_t err;
 
+	_gpgme_op_stats_started (ctx);
+	err = ctx_active (ctx);
 	if (err)
 	  /* An error occurred.  Close all fds in this context, and
 	     send the error in a done event.  */
@@ -217,6 +219,7 @@ _gpgme_wait_global_event_cb (void *data, gpgme_event_io_t type,
 	gpgme_io_event_done_data_t done_data =
 	  (gpgme_io_event_done_data_t) type_data;
 
+	_gpgme_op_stats_done (ctx);
 	ctx_done (ctx, done_data->err, done_data->op_err);
       }
       break;
@@ -315,11 +318,12 @@ gpgme_wait_ext (gpgme_ctx_t ctx, gpgme_error_t *status,
 	      assert (item);
 	      ictx = item->ctx;
 	      assert (ictx);
+	      ictx->stats.wakeups++;
 
-	      LOCK (ctx->lock);
-	      if (ctx->canceled)
+	      LOCK (ictx->lock);
+	      if (ictx->canceled)
 		err = gpg_error (GPG_ERR_CANCELED);
-	      UNLOCK (ctx->lock);
+	      UNLOCK (ictx->lock);
 
 	      if (!err)
 		err = _gpgme_run_io_cb (&fdt.fds[i], 0, &local_op_err);
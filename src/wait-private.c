@@ -51,11 +51,13 @@ _gpgme_wait_private_event_cb (void *data, gpgme_event_io_t type,
   switch (type)
     {
     case GPGME_EVENT_START:
-      /* Nothing to do here, as the wait routine is called after the
-	 initialization is finished.  */
+      /* Nothing else to do here, as the wait routine is called after
+	 the initialization is finished.  */
+      _gpgme_op_stats_started (data);
       break;
 
     case GPGME_EVENT_DONE:
+      _gpgme_op_stats_done (data);
       break;
 
     case GPGME_EVENT_NEXT_KEY:
@@ -96,6 +98,8 @@ _gpgme_wait_on_condition (gpgme_ctx_t ctx, volatile int *cond,
 
 	  return err;
 	}
+      if (nr)
+        ctx->stats.wakeups++;
 
       for (i = 0; i < ctx->fdt.size && nr; i++)
 	{
@@ -51,6 +51,7 @@ _gpgme_user_io_cb_handler (void *data, int fd)
   assert (data);
   ctx = tag->ctx;
   assert (ctx);
+  ctx->stats.wakeups++;
 
   LOCK (ctx->lock);
   if (ctx->canceled)
@@ -128,6 +129,11 @@ _gpgme_wait_user_event_cb (void *data, gpgme_event_io_t type, void *type_data)
 {
   gpgme_ctx_t ctx = data;
 
+  if (type == GPGME_EVENT_START)
+    _gpgme_op_stats_started (ctx);
+  else if (type == GPGME_EVENT_DONE)
+    _gpgme_op_stats_done (ctx);
+
   if (ctx->io_cbs.event)
     (*ctx->io_cbs.event) (ctx->io_cbs.event_priv, type, type_data);
 }
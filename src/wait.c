@@ -215,7 +215,14 @@ _gpgme_run_io_cb (struct io_select_fd_s *an_fds, int checked,
 
   iocb_data.handler_value = item->handler_value;
   iocb_data.op_err = 0;
+  iocb_data.stats = &item->ctx->stats;
+  if (item->dir)
+    iocb_data.stats->read_calls++;
+  else
+    iocb_data.stats->write_calls++;
+  TRACE_SPAN_BEGIN (item->dir? "io-read" : "io-write", item->handler_value);
   err = item->handler (&iocb_data, an_fds->fd);
+  TRACE_SPAN_END (item->dir? "io-read" : "io-write", item->handler_value);
 
   *op_err = iocb_data.op_err;
   return err;
@@ -91,6 +91,9 @@ struct io_cb_data
 
   /* The I/O callback can pass an operational error here.  */
   gpgme_error_t op_err;
+
+  /* The statistics of the operation; the callback may update them.  */
+  gpgme_op_stats_t stats;
 };
 
 #endif	/* WAIT_H */
@@ -0,0 +1,1118 @@
+/* bench-gpgme.c - End-to-end benchmarks for GPGME
+ * Copyright (C) 2026 g10 Code GmbH
+ *
+ * This file is part of GPGME.
+ *
+ * GPGME is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * GPGME is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, see <https://gnu.org/licenses/>.
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+/* This program is run by "make bench".  Each result is printed as
+ * one JSON object per line so that the results of different releases
+ * can easily be compared by scripts.  All benchmarks use the
+ * GNUPGHOME from the environment, except for the keylist benchmarks
+ * which use the keyring directories given with --keyring.  The parse
+ * benchmarks do not run gpg at all but replay the transcripts
+ * recorded by mktranscripts to measure the parsers in isolation.
+ * The load benchmark uses the paced mode of the replay engine to
+ * stress the event loop and the data pumping with many concurrent
+ * operations.  */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <pthread.h>
+
+#include <gpgme.h>
+
+#define PGM "bench-gpgme"
+
+#define fail_if_err(err)					\
+  do								\
+    {								\
+      if (err)							\
+        {							\
+          fprintf (stderr, PGM": file %s line %d: <%s> %s\n",	\
+                   __FILE__, __LINE__, gpgme_strsource (err),	\
+		   gpgme_strerror (err));			\
+          exit (1);						\
+        }							\
+    }								\
+  while (0)
+
+/* The maximum number of latencies recorded per benchmark.  */
+#define MAX_SAMPLES 10000
+
+/* The size of the messages used by the thread and JSON benchmarks.  */
+#define SMALL_SIZE 4096
+
+static int verbose;
+
+/* Each benchmark is repeated until it ran for at least this number
+ * of microseconds.  */
+static unsigned long long min_usec = 2000000;
+
+/* The fingerprint of the key used for the crypto benchmarks.  */
+static char *bench_fpr;
+
+/* The name of the scratch file for the ciphertext.  */
+static const char *tmp_name = "bench-tmp.gpg";
+
+
+
+static unsigned long long
+now_usec (void)
+{
+  struct timespec tp;
+
+  clock_gettime (CLOCK_MONOTONIC, &tp);
+  return (unsigned long long)tp.tv_sec * 1000000 + tp.tv_nsec / 1000;
+}
+
+
+static int
+cmp_ull (const void *a, const void *b)
+{
+  unsigned long long x = *(const unsigned long long *)a;
+  unsigned long long y = *(const unsigned long long *)b;
+
+  return x < y? -1 : x > y;
+}
+
+
+/* Print the result of benchmark NAME with parameter PARAM.  LAT has
+ * the latencies of N operations which took TOTAL microseconds;
+ * NOPS is the number of operations if that is larger than N.  BYTES
+ * is the number of bytes processed by one operation or 0.  */
+static void
+report (const char *name, unsigned long long param,
+        unsigned long long *lat, size_t n, unsigned long long nops,
+        unsigned long long total, unsigned long long bytes)
+{
+  double secs = total / 1e6;
+
+  if (nops < n)
+    nops = n;
+  if (!n || !total)
+    return;
+  qsort (lat, n, sizeof *lat, cmp_ull);
+
+  printf ("{\"bench\":\"%s\",\"param\":%llu,\"ops\":%llu,"
+          "\"total_usec\":%llu,\"min_usec\":%llu,\"median_usec\":%llu,"
+          "\"p99_usec\":%llu,\"max_usec\":%llu,\"ops_per_sec\":%.2f",
+          name, param, nops, total,
+          lat[0], lat[n / 2], lat[(n * 99) / 100], lat[n - 1],
+          nops / secs);
+  if (bytes)
+    printf (",\"bytes_per_sec\":%.0f", bytes * nops / secs);
+  printf ("}\n");
+  fflush (stdout);
+}
+
+
+/* Parse the comma separated list of numbers STRING into a malloced
+ * array stored at R_LIST and return the number of items.  */
+static size_t
+parse_list (const char *string, unsigned long long **r_list)
+{
+  unsigned long long *list;
+  const char *s;
+  char *endp;
+  size_t n;
+
+  for (n = 1, s = string; (s = strchr (s, ',')); s++)
+    n++;
+  list = calloc (n, sizeof *list);
+  if (!list)
+    {
+      perror (PGM);
+      exit (1);
+    }
+  for (n = 0, s = string; *s; n++)
+    {
+      list[n] = strtoull (s, &endp, 10);
+      if (endp == s || (*endp && *endp != ','))
+        {
+          fprintf (stderr, PGM ": invalid list '%s'\n", string);
+          exit (1);
+        }
+      s = *endp? endp + 1 : endp;
+    }
+  *r_list = list;
+  return n;
+}
+
+
+
+/* A data object with reproducible pseudo-random content of a given
+ * size.  The content is not compressible.  */
+struct gen_data_s
+{
+  unsigned long long size;
+  unsigned long long pos;
+  uint64_t state;
+};
+
+
+static gpgme_ssize_t
+gen_read (void *handle, void *buffer, size_t size)
+{
+  struct gen_data_s *gen = handle;
+  unsigned char *p = buffer;
+  size_t n;
+
+  if (size > gen->size - gen->pos)
+    size = gen->size - gen->pos;
+  for (n = 0; n < size; n++)
+    {
+      if (!(gen->pos & 7))
+        {
+          gen->state ^= gen->state << 13;
+          gen->state ^= gen->state >> 7;
+          gen->state ^= gen->state << 17;
+        }
+      p[n] = gen->state >> ((gen->pos & 7) * 8);
+      gen->pos++;
+    }
+  return size;
+}
+
+
+static gpgme_off_t
+gen_seek (void *handle, gpgme_off_t offset, int whence)
+{
+  struct gen_data_s *gen = handle;
+
+  if (whence == SEEK_CUR && !offset)
+    return gen->pos;
+  if (whence != SEEK_SET || offset)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+  gen->pos = 0;
+  gen->state = 0x9e3779b97f4a7c15ULL;
+  return 0;
+}
+
+
+static struct gpgme_data_cbs gen_cbs = { gen_read, NULL, gen_seek, NULL };
+
+
+static gpgme_data_t
+gen_data_new (struct gen_data_s *gen, unsigned long long size)
+{
+  gpgme_data_t data;
+
+  gen->size = size;
+  gen_seek (gen, 0, SEEK_SET);
+  fail_if_err (gpgme_data_new_from_cbs (&data, &gen_cbs, gen));
+  return data;
+}
+
+
+/* A data object which only counts the bytes written to it.  */
+static gpgme_ssize_t
+sink_write (void *handle, const void *buffer, size_t size)
+{
+  (void)buffer;
+  *(unsigned long long *)handle += size;
+  return size;
+}
+
+
+static struct gpgme_data_cbs sink_cbs = { NULL, sink_write, NULL, NULL };
+
+
+static gpgme_data_t
+sink_data_new (unsigned long long *counter)
+{
+  gpgme_data_t data;
+
+  *counter = 0;
+  fail_if_err (gpgme_data_new_from_cbs (&data, &sink_cbs, counter));
+  return data;
+}
+
+
+
+static gpgme_ctx_t
+new_context (void)
+{
+  gpgme_ctx_t ctx;
+
+  fail_if_err (gpgme_new (&ctx));
+  gpgme_set_protocol (ctx, GPGME_PROTOCOL_OpenPGP);
+  gpgme_set_pinentry_mode (ctx, GPGME_PINENTRY_MODE_LOOPBACK);
+  return ctx;
+}
+
+
+/* Find the secret key used for the benchmarks.  */
+static gpgme_key_t
+get_bench_key (void)
+{
+  gpgme_ctx_t ctx = new_context ();
+  gpgme_key_t key;
+
+  fail_if_err (gpgme_op_keylist_start (ctx, NULL, 1));
+  fail_if_err (gpgme_op_keylist_next (ctx, &key));
+  gpgme_op_keylist_end (ctx);
+  gpgme_release (ctx);
+  bench_fpr = strdup (key->fpr);
+  if (!bench_fpr)
+    {
+      perror (PGM);
+      exit (1);
+    }
+  return key;
+}
+
+
+/* Encrypt SIZE bytes to KEY and write the ciphertext to OUT.  */
+static void
+do_encrypt (gpgme_ctx_t ctx, gpgme_key_t key, unsigned long long size,
+            gpgme_data_t out)
+{
+  struct gen_data_s gen;
+  gpgme_key_t keys[2] = { key, NULL };
+  gpgme_data_t in = gen_data_new (&gen, size);
+
+  fail_if_err (gpgme_op_encrypt (ctx, keys, GPGME_ENCRYPT_ALWAYS_TRUST,
+                                 in, out));
+  gpgme_data_release (in);
+}
+
+
+static void
+bench_crypto (gpgme_key_t key, unsigned long long size)
+{
+  static unsigned long long lat[MAX_SAMPLES];
+  gpgme_ctx_t ctx = new_context ();
+  unsigned long long start, t, total, count;
+  struct gen_data_s gen;
+  gpgme_data_t in, out, sig;
+  FILE *fp;
+  size_t n;
+
+  gpgme_signers_add (ctx, key);
+
+  /* Encrypt.  */
+  start = now_usec ();
+  for (n = 0, total = 0; n < MAX_SAMPLES && (!n || total < min_usec); n++)
+    {
+      out = sink_data_new (&count);
+      t = now_usec ();
+      do_encrypt (ctx, key, size, out);
+      lat[n] = now_usec () - t;
+      gpgme_data_release (out);
+      total = now_usec () - start;
+    }
+  report ("encrypt", size, lat, n, 0, total, size);
+
+  /* Decrypt.  The ciphertext is created once in a scratch file.  */
+  fp = fopen (tmp_name, "w+b");
+  if (!fp)
+    {
+      perror (tmp_name);
+      exit (1);
+    }
+  fail_if_err (gpgme_data_new_from_stream (&in, fp));
+  do_encrypt (ctx, key, size, in);
+  start = now_usec ();
+  for (n = 0, total = 0; n < MAX_SAMPLES && (!n || total < min_usec); n++)
+    {
+      gpgme_data_seek (in, 0, SEEK_SET);
+      out = sink_data_new (&count);
+      t = now_usec ();
+      fail_if_err (gpgme_op_decrypt (ctx, in, out));
+      lat[n] = now_usec () - t;
+      if (count != size)
+        {
+          fprintf (stderr, PGM ": decrypt returned %llu bytes\n", count);
+          exit (1);
+        }
+      gpgme_data_release (out);
+      total = now_usec () - start;
+    }
+  report ("decrypt", size, lat, n, 0, total, size);
+  gpgme_data_release (in);
+  fclose (fp);
+  remove (tmp_name);
+
+  /* Sign.  */
+  start = now_usec ();
+  for (n = 0, total = 0; n < MAX_SAMPLES && (!n || total < min_usec); n++)
+    {
+      in = gen_data_new (&gen, size);
+      out = sink_data_new (&count);
+      t = now_usec ();
+      fail_if_err (gpgme_op_sign (ctx, in, out, GPGME_SIG_MODE_DETACH));
+      lat[n] = now_usec () - t;
+      gpgme_data_release (out);
+      gpgme_data_release (in);
+      total = now_usec () - start;
+    }
+  report ("sign", size, lat, n, 0, total, size);
+
+  /* Verify a detached signature.  */
+  fail_if_err (gpgme_data_new (&sig));
+  in = gen_data_new (&gen, size);
+  fail_if_err (gpgme_op_sign (ctx, in, sig, GPGME_SIG_MODE_DETACH));
+  gpgme_data_release (in);
+  start = now_usec ();
+  for (n = 0, total = 0; n < MAX_SAMPLES && (!n || total < min_usec); n++)
+    {
+      gpgme_verify_result_t result;
+
+      gpgme_data_seek (sig, 0, SEEK_SET);
+      in = gen_data_new (&gen, size);
+      t = now_usec ();
+      fail_if_err (gpgme_op_verify (ctx, sig, in, NULL));
+      lat[n] = now_usec () - t;
+      result = gpgme_op_verify_result (ctx);
+      if (!result->signatures
+          || gpg_err_code (result->signatures->status) != GPG_ERR_NO_ERROR)
+        {
+          fprintf (stderr, PGM ": bad signature\n");
+          exit (1);
+        }
+      gpgme_data_release (in);
+      total = now_usec () - start;
+    }
+  report ("verify", size, lat, n, 0, total, size);
+  gpgme_data_release (sig);
+
+  gpgme_release (ctx);
+}
+
+
+
+/* Run the keylist benchmarks on the keyring in the directory HOME.  */
+static void
+bench_keyring (const char *home)
+{
+  static unsigned long long lat[MAX_SAMPLES];
+  gpgme_ctx_t ctx = new_context ();
+  gpgme_key_t key;
+  gpgme_error_t err;
+  unsigned long long start, t, total, nkeys;
+  char **fprs = NULL;
+  size_t n, nfprs = 0;
+
+  fail_if_err (gpgme_ctx_set_engine_info (ctx, GPGME_PROTOCOL_OpenPGP,
+                                          NULL, home));
+
+  /* List all keys.  The first run also collects the fingerprints
+   * for the lookups.  */
+  start = now_usec ();
+  for (n = 0, total = 0; n < MAX_SAMPLES && (!n || total < min_usec); n++)
+    {
+      t = now_usec ();
+      fail_if_err (gpgme_op_keylist_start (ctx, NULL, 0));
+      nkeys = 0;
+      while (!(err = gpgme_op_keylist_next (ctx, &key)))
+        {
+          if (!n)
+            {
+              if (!(nfprs % 1024))
+                {
+                  fprs = realloc (fprs, (nfprs + 1024) * sizeof *fprs);
+                  if (!fprs)
+                    {
+                      perror (PGM);
+                      exit (1);
+                    }
+                }
+              fprs[nfprs++] = strdup (key->fpr);
+            }
+          gpgme_key_unref (key);
+          nkeys++;
+        }
+      if (gpg_err_code (err) != GPG_ERR_EOF)
+        fail_if_err (err);
+      lat[n] = now_usec () - t;
+      total = now_usec () - start;
+    }
+  if (!nkeys)
+    {
+      fprintf (stderr, PGM ": no keys in '%s'\n", home);
+      exit (1);
+    }
+  report ("keylist", nkeys, lat, n, 0, total, 0);
+
+  /* Look up random keys by fingerprint.  */
+  srand (1);
+  start = now_usec ();
+  for (n = 0, total = 0; n < MAX_SAMPLES && (!n || total < min_usec); n++)
+    {
+      t = now_usec ();
+      fail_if_err (gpgme_get_key (ctx, fprs[rand () % nfprs], &key, 0));
+      lat[n] = now_usec () - t;
+      gpgme_key_unref (key);
+      total = now_usec () - start;
+    }
+  report ("get_key", nkeys, lat, n, 0, total, 0);
+
+  for (n = 0; n < nfprs; n++)
+    free (fprs[n]);
+  free (fprs);
+  gpgme_release (ctx);
+}
+
+
+
+/* The state shared by the threads of the concurrency benchmark.  */
+struct thread_arg_s
+{
+  gpgme_key_t key;
+  unsigned long long deadline;
+  unsigned long long ops;
+  unsigned long long *lat;
+  size_t nlat;
+};
+
+
+/* Encrypt and decrypt small messages until the deadline.  */
+static void *
+thread_main (void *opaque)
+{
+  struct thread_arg_s *arg = opaque;
+  gpgme_ctx_t ctx = new_context ();
+  unsigned long long t, count;
+  gpgme_data_t cipher, out;
+
+  do
+    {
+      t = now_usec ();
+      fail_if_err (gpgme_data_new (&cipher));
+      do_encrypt (ctx, arg->key, SMALL_SIZE, cipher);
+      gpgme_data_seek (cipher, 0, SEEK_SET);
+      out = sink_data_new (&count);
+      fail_if_err (gpgme_op_decrypt (ctx, cipher, out));
+      gpgme_data_release (out);
+      gpgme_data_release (cipher);
+      if (arg->nlat < MAX_SAMPLES)
+        arg->lat[arg->nlat++] = now_usec () - t;
+      arg->ops++;
+    }
+  while (now_usec () < arg->deadline);
+
+  gpgme_release (ctx);
+  return NULL;
+}
+
+
+static void
+bench_threads (gpgme_key_t key, unsigned int nthreads)
+{
+  static unsigned long long lat[MAX_SAMPLES];
+  struct thread_arg_s *args;
+  pthread_t *threads;
+  unsigned long long start, ops = 0;
+  size_t i, n = 0;
+
+  args = calloc (nthreads, sizeof *args);
+  threads = calloc (nthreads, sizeof *threads);
+  if (!args || !threads)
+    {
+      perror (PGM);
+      exit (1);
+    }
+
+  start = now_usec ();
+  for (i = 0; i < nthreads; i++)
+    {
+      args[i].key = key;
+      args[i].deadline = start + min_usec;
+      args[i].lat = calloc (MAX_SAMPLES, sizeof *args[i].lat);
+      if (!args[i].lat)
+        {
+          perror (PGM);
+          exit (1);
+        }
+      if (pthread_create (&threads[i], NULL, thread_main, &args[i]))
+        {
+          fprintf (stderr, PGM ": error creating thread\n");
+          exit (1);
+        }
+    }
+  for (i = 0; i < nthreads; i++)
+    {
+      size_t j;
+
+      pthread_join (threads[i], NULL);
+      ops += args[i].ops;
+      for (j = 0; j < args[i].nlat && n < MAX_SAMPLES; j++)
+        lat[n++] = args[i].lat[j];
+      free (args[i].lat);
+    }
+  report ("threads", nthreads, lat, n, ops, now_usec () - start,
+          SMALL_SIZE);
+
+  free (threads);
+  free (args);
+}
+
+
+
+/* Append a native messaging request with the JSON object REQUEST to
+ * DATA.  */
+static void
+json_add_request (gpgme_data_t data, const char *request)
+{
+  uint32_t len = strlen (request);
+
+  if (gpgme_data_write (data, &len, sizeof len) != sizeof len
+      || gpgme_data_write (data, request, len) != len)
+    fail_if_err (gpg_error_from_syserror ());
+}
+
+
+/* Run the JSON server GPGME_JSON with NREQUESTS copies of REQUEST.  */
+static void
+bench_json_run (const char *gpgme_json, const char *name,
+                const char *request, unsigned int nrequests)
+{
+  static unsigned long long lat[1];
+  gpgme_ctx_t ctx;
+  gpgme_data_t in, out, err;
+  unsigned long long t, count, errcount;
+  const char *argv[2];
+  unsigned int i;
+
+  fail_if_err (gpgme_new (&ctx));
+  fail_if_err (gpgme_set_protocol (ctx, GPGME_PROTOCOL_SPAWN));
+  fail_if_err (gpgme_data_new (&in));
+  for (i = 0; i < nrequests; i++)
+    json_add_request (in, request);
+  gpgme_data_seek (in, 0, SEEK_SET);
+  out = sink_data_new (&count);
+  err = sink_data_new (&errcount);
+
+  argv[0] = gpgme_json;
+  argv[1] = NULL;
+  t = now_usec ();
+  fail_if_err (gpgme_op_spawn (ctx, gpgme_json, argv, in, out, err, 0));
+  lat[0] = now_usec () - t;
+  if (errcount)
+    {
+      fprintf (stderr, PGM ": %s wrote to stderr\n", gpgme_json);
+      exit (1);
+    }
+  /* A single session is measured; thus the latency is the mean.  */
+  lat[0] /= nrequests;
+  report (name, nrequests, lat, 1, nrequests, lat[0] * nrequests, 0);
+
+  gpgme_data_release (err);
+  gpgme_data_release (out);
+  gpgme_data_release (in);
+  gpgme_release (ctx);
+}
+
+
+static void
+bench_json (const char *gpgme_json)
+{
+  char *request;
+  char *p;
+
+  bench_json_run (gpgme_json, "json-version", "{\"op\":\"version\"}", 1000);
+
+  request = malloc (SMALL_SIZE + strlen (bench_fpr) + 100);
+  if (!request)
+    {
+      perror (PGM);
+      exit (1);
+    }
+  p = request + sprintf (request, "{\"op\":\"encrypt\",\"keys\":\"%s\","
+                         "\"always-trust\":true,\"data\":\"", bench_fpr);
+  memset (p, 'a', SMALL_SIZE);
+  strcpy (p + SMALL_SIZE, "\"}");
+  bench_json_run (gpgme_json, "json-encrypt", request, 100);
+  free (request);
+}
+
+
+
+/* Run the operation OP of a parse benchmark once with CTX.  */
+static void
+parse_run_op (gpgme_ctx_t ctx, const char *op)
+{
+  gpgme_data_t in, out;
+  gpgme_key_t key;
+  gpgme_conf_comp_t conf;
+  gpgme_error_t err;
+  unsigned long long count;
+
+  if (!strcmp (op, "keylist"))
+    {
+      fail_if_err (gpgme_op_keylist_start (ctx, NULL, 0));
+      while (!(err = gpgme_op_keylist_next (ctx, &key)))
+        gpgme_key_unref (key);
+      if (gpg_err_code (err) != GPG_ERR_EOF)
+        fail_if_err (err);
+    }
+  else if (!strcmp (op, "conf"))
+    {
+      fail_if_err (gpgme_op_conf_load (ctx, &conf));
+      gpgme_conf_release (conf);
+    }
+  else
+    {
+      fail_if_err (gpgme_data_new_from_mem (&in, "", 0, 0));
+      out = sink_data_new (&count);
+      if (!strcmp (op, "decrypt"))
+        fail_if_err (gpgme_op_decrypt (ctx, in, out));
+      else
+        fail_if_err (gpgme_op_verify (ctx, in, out, NULL));
+      gpgme_data_release (out);
+      gpgme_data_release (in);
+    }
+}
+
+
+/* Replay the transcript FNAME in DIR and report the time taken by
+ * the parsers.  The operation is derived from the file name.  */
+static void
+bench_parse_file (const char *dir, const char *fname)
+{
+  static unsigned long long lat[MAX_SAMPLES];
+  gpgme_ctx_t ctx;
+  unsigned long long start, t, total;
+  char name[64];
+  char *file;
+  struct stat st;
+  size_t n;
+
+  n = strcspn (fname, "-.");
+  if (n > 32)
+    return;
+  strcpy (name, "parse-");
+  memcpy (name + 6, fname, n);
+  name[6 + n] = 0;
+  if (strcmp (name, "parse-keylist") && strcmp (name, "parse-conf")
+      && strcmp (name, "parse-decrypt") && strcmp (name, "parse-verify"))
+    return;
+
+  file = malloc (strlen (dir) + strlen (fname) + 2);
+  if (!file)
+    {
+      perror (PGM);
+      exit (1);
+    }
+  sprintf (file, "%s/%s", dir, fname);
+  if (stat (file, &st))
+    {
+      perror (file);
+      exit (1);
+    }
+
+  fail_if_err (gpgme_new (&ctx));
+  fail_if_err (gpgme_set_ctx_flag (ctx, "replay", file));
+
+  start = now_usec ();
+  for (n = 0, total = 0; n < MAX_SAMPLES && (!n || total < min_usec); n++)
+    {
+      t = now_usec ();
+      parse_run_op (ctx, name + 6);
+      lat[n] = now_usec () - t;
+      total = now_usec () - start;
+    }
+  report (name, st.st_size, lat, n, 0, total, st.st_size);
+
+  gpgme_release (ctx);
+  free (file);
+}
+
+
+static int
+cmp_string (const void *a, const void *b)
+{
+  return strcmp (*(char *const *)a, *(char *const *)b);
+}
+
+
+/* Run the parse benchmarks for all transcripts in DIR.  */
+static void
+bench_parse (const char *dir)
+{
+  DIR *dp;
+  struct dirent *de;
+  char **names = NULL;
+  size_t i, n = 0;
+
+  dp = opendir (dir);
+  if (!dp)
+    {
+      perror (dir);
+      exit (1);
+    }
+  while ((de = readdir (dp)))
+    {
+      size_t len = strlen (de->d_name);
+
+      if (len < 6 || strcmp (de->d_name + len - 6, ".trans"))
+        continue;
+      names = realloc (names, (n + 1) * sizeof *names);
+      if (!names || !(names[n] = strdup (de->d_name)))
+        {
+          perror (PGM);
+          exit (1);
+        }
+      n++;
+    }
+  closedir (dp);
+
+  qsort (names, n, sizeof *names, cmp_string);
+  for (i = 0; i < n; i++)
+    {
+      if (verbose)
+        fprintf (stderr, PGM ": parse %s\n", names[i]);
+      bench_parse_file (dir, names[i]);
+      free (names[i]);
+    }
+  free (names);
+}
+
+
+
+/* Run decrypt operations answered by the replay engine using
+ * TRANSCRIPT and paced as given by PACE on NCTX contexts at once.  The
+ * operations are driven by the global event loop and each finished
+ * operation is restarted until the time is up.  */
+static void
+bench_load (const char *transcript, const char *pace, unsigned int nctx)
+{
+  static unsigned long long lat[MAX_SAMPLES];
+  static char input[SMALL_SIZE];
+  gpgme_ctx_t *ctxs;
+  gpgme_data_t *ins;
+  unsigned long long *started;
+  unsigned long long start, now, ops = 0, count;
+  gpgme_data_t out;
+  gpgme_ctx_t ctx;
+  gpgme_error_t err, op_err;
+  unsigned int i, active;
+  size_t n = 0;
+
+  ctxs = calloc (nctx, sizeof *ctxs);
+  ins = calloc (nctx, sizeof *ins);
+  started = calloc (nctx, sizeof *started);
+  if (!ctxs || !ins || !started)
+    {
+      perror (PGM);
+      exit (1);
+    }
+  memset (input, 'a', sizeof input);
+  out = sink_data_new (&count);
+
+  start = now_usec ();
+  for (i = 0; i < nctx; i++)
+    {
+      fail_if_err (gpgme_new (&ctxs[i]));
+      fail_if_err (gpgme_set_ctx_flag (ctxs[i], "replay", transcript));
+      fail_if_err (gpgme_set_ctx_flag (ctxs[i], "replay-pace", pace));
+      fail_if_err (gpgme_data_new_from_mem (&ins[i], input, sizeof input, 0));
+      started[i] = now_usec ();
+      fail_if_err (gpgme_op_decrypt_start (ctxs[i], ins[i], out));
+    }
+
+  for (active = nctx; active; )
+    {
+      ctx = gpgme_wait_ext (NULL, &err, &op_err, 1);
+      if (!ctx)
+        {
+          fail_if_err (err);
+          continue;
+        }
+      fail_if_err (err);
+      fail_if_err (op_err);
+      if (!gpgme_op_decrypt_result (ctx))
+        {
+          fprintf (stderr, PGM ": no decrypt result\n");
+          exit (1);
+        }
+
+      for (i = 0; ctxs[i] != ctx; i++)
+        ;
+      now = now_usec ();
+      if (n < MAX_SAMPLES)
+        lat[n++] = now - started[i];
+      ops++;
+
+      if (now - start < min_usec)
+        {
+          gpgme_data_seek (ins[i], 0, SEEK_SET);
+          started[i] = now;
+          fail_if_err (gpgme_op_decrypt_start (ctx, ins[i], out));
+        }
+      else
+        active--;
+    }
+  report ("load", nctx, lat, n, ops, now_usec () - start, SMALL_SIZE);
+
+  for (i = 0; i < nctx; i++)
+    {
+      gpgme_release (ctxs[i]);
+      gpgme_data_release (ins[i]);
+    }
+  gpgme_data_release (out);
+  free (started);
+  free (ins);
+  free (ctxs);
+}
+
+
+
+static int
+show_usage (int ex)
+{
+  fputs ("usage: " PGM " [options] [BENCH...]\n\n"
+         "Benchmarks: crypto keylist threads json parse load"
+         " (default: all)\n\n"
+         "Options:\n"
+         "  --verbose          run in verbose mode\n"
+         "  --min-time N       run each benchmark for N ms (default 2000)\n"
+         "  --sizes LIST       message sizes for the crypto benchmarks\n"
+         "  --threads LIST     thread counts for the threads benchmark\n"
+         "  --keyring DIR      use the keyring in DIR for the keylist\n"
+         "                     benchmark; may be given several times\n"
+         "  --gpgme-json FILE  use FILE for the json benchmark\n"
+         "  --transcripts DIR  use the transcripts in DIR for the parse\n"
+         "                     and load benchmarks\n"
+         "  --concurrency LIST numbers of concurrent operations for the\n"
+         "                     load benchmark\n"
+         "  --replay-pace PACE pacing of the replay engine for the load\n"
+         "                     benchmark (default: 1000)\n"
+         , stderr);
+  exit (ex);
+}
+
+
+static int
+want_bench (char **names, int n, const char *name)
+{
+  int i;
+
+  if (!n)
+    return 1;
+  for (i = 0; i < n; i++)
+    if (!strcmp (names[i], name))
+      return 1;
+  return 0;
+}
+
+
+int
+main (int argc, char **argv)
+{
+  int last_argc = -1;
+  const char *sizes = "1024,65536,1048576,16777216";
+  const char *thread_counts = "1,2,4,8,16,32,64";
+  const char *gpgme_json = NULL;
+  const char *transcripts = NULL;
+  const char *concurrency = "1,16,64";
+  const char *replay_pace = "1000";
+  const char **keyrings = NULL;
+  int nkeyrings = 0;
+  unsigned long long *list;
+  size_t i, n;
+  gpgme_engine_info_t info;
+  gpgme_key_t key;
+
+  if (argc)
+    { argc--; argv++; }
+
+  while (argc && last_argc != argc )
+    {
+      last_argc = argc;
+      if (!strcmp (*argv, "--"))
+        {
+          argc--; argv++;
+          break;
+        }
+      else if (!strcmp (*argv, "--help"))
+        show_usage (0);
+      else if (!strcmp (*argv, "--verbose"))
+        {
+          verbose = 1;
+          argc--; argv++;
+        }
+      else if (!strcmp (*argv, "--min-time"))
+        {
+          argc--; argv++;
+          if (!argc)
+            show_usage (1);
+          min_usec = strtoull (*argv, NULL, 10) * 1000;
+          argc--; argv++;
+        }
+      else if (!strcmp (*argv, "--sizes"))
+        {
+          argc--; argv++;
+          if (!argc)
+            show_usage (1);
+          sizes = *argv;
+          argc--; argv++;
+        }
+      else if (!strcmp (*argv, "--threads"))
+        {
+          argc--; argv++;
+          if (!argc)
+            show_usage (1);
+          thread_counts = *argv;
+          argc--; argv++;
+        }
+      else if (!strcmp (*argv, "--keyring"))
+        {
+          argc--; argv++;
+          if (!argc)
+            show_usage (1);
+          keyrings = realloc (keyrings, (nkeyrings + 1) * sizeof *keyrings);
+          if (!keyrings)
+            {
+              perror (PGM);
+              exit (1);
+            }
+          keyrings[nkeyrings++] = *argv;
+          argc--; argv++;
+        }
+      else if (!strcmp (*argv, "--gpgme-json"))
+        {
+          argc--; argv++;
+          if (!argc)
+            show_usage (1);
+          gpgme_json = *argv;
+          argc--; argv++;
+        }
+      else if (!strcmp (*argv, "--transcripts"))
+        {
+          argc--; argv++;
+          if (!argc)
+            show_usage (1);
+          transcripts = *argv;
+          argc--; argv++;
+        }
+      else if (!strcmp (*argv, "--concurrency"))
+        {
+          argc--; argv++;
+          if (!argc)
+            show_usage (1);
+          concurrency = *argv;
+          argc--; argv++;
+        }
+      else if (!strcmp (*argv, "--replay-pace"))
+        {
+          argc--; argv++;
+          if (!argc)
+            show_usage (1);
+          replay_pace = *argv;
+          argc--; argv++;
+        }
+      else if (!strncmp (*argv, "--", 2))
+        show_usage (1);
+    }
+
+  gpgme_check_version (NULL);
+  fail_if_err (gpgme_engine_check_version (GPGME_PROTOCOL_OpenPGP));
+  fail_if_err (gpgme_get_engine_info (&info));
+  while (info && info->protocol != GPGME_PROTOCOL_OpenPGP)
+    info = info->next;
+
+  printf ("{\"bench\":\"info\",\"gpgme\":\"%s\",\"gnupg\":\"%s\","
+          "\"cpus\":%ld,\"time\":%lu}\n",
+          gpgme_check_version (NULL), info? info->version : "",
+          sysconf (_SC_NPROCESSORS_ONLN), (unsigned long)time (NULL));
+  fflush (stdout);
+
+  key = get_bench_key ();
+
+  if (want_bench (argv, argc, "crypto"))
+    {
+      n = parse_list (sizes, &list);
+      for (i = 0; i < n; i++)
+        {
+          if (verbose)
+            fprintf (stderr, PGM ": crypto %llu\n", list[i]);
+          bench_crypto (key, list[i]);
+        }
+      free (list);
+    }
+
+  if (want_bench (argv, argc, "keylist"))
+    for (i = 0; i < (size_t)nkeyrings; i++)
+      {
+        if (verbose)
+          fprintf (stderr, PGM ": keylist %s\n", keyrings[i]);
+        bench_keyring (keyrings[i]);
+      }
+
+  if (want_bench (argv, argc, "threads"))
+    {
+      n = parse_list (thread_counts, &list);
+      for (i = 0; i < n; i++)
+        {
+          if (verbose)
+            fprintf (stderr, PGM ": threads %llu\n", list[i]);
+          bench_threads (key, list[i]);
+        }
+      free (list);
+    }
+
+  if (gpgme_json && want_bench (argv, argc, "json"))
+    {
+      if (verbose)
+        fprintf (stderr, PGM ": json\n");
+      bench_json (gpgme_json);
+    }
+
+  if (transcripts && want_bench (argv, argc, "parse"))
+    bench_parse (transcripts);
+
+  if (transcripts && want_bench (argv, argc, "load"))
+    {
+      char *transcript = malloc (strlen (transcripts) + 20);
+
+      if (!transcript)
+        {
+          perror (PGM);
+          exit (1);
+        }
+      sprintf (transcript, "%s/decrypt.trans", transcripts);
+      n = parse_list (concurrency, &list);
+      for (i = 0; i < n; i++)
+        {
+          if (verbose)
+            fprintf (stderr, PGM ": load %llu\n", list[i]);
+          bench_load (transcript, replay_pace, list[i]);
+        }
+      free (list);
+      free (transcript);
+    }
+
+  gpgme_key_unref (key);
+  free (keyrings);
+  free (bench_fpr);
+  return 0;
+}
@@ -245,6 +245,36 @@ lookup (gpgme_conf_comp_t conf,
   return 0;		/* Not found.  */
 }
 
+
+/* Replace the first occurrence of OLDVAL in the file FNAME by NEWVAL
+   without using gpgconf.  Returns 0 on success.  */
+static int
+edit_file (const char *fname, const char *oldval, const char *newval)
+{
+  static char buf[65536];
+  FILE *fp;
+  size_t n;
+  char *p;
+
+  fp = fopen (fname, "rb");
+  if (!fp)
+    return -1;
+  n = fread (buf, 1, sizeof buf - 1, fp);
+  fclose (fp);
+  buf[n] = 0;
+  p = strstr (buf, oldval);
+  if (!p)
+    return -1;
+
+  fp = fopen (fname, "wb");
+  if (!fp)
+    return -1;
+  fwrite (buf, 1, p - buf, fp);
+  fputs (newval, fp);
+  fputs (p + strlen (oldval), fp);
+  return fclose (fp);
+}
+
 #include <assert.h>
 
 
@@ -381,6 +411,34 @@ main (void)
     fprintf (stderr, ".");
     fflush (stderr);
   }
+
+  /* Change the keyserver behind gpgconf's back and check that the
+     reload does not return stale data.  */
+  {
+    gpgme_conf_opt_t opt;
+
+    if (lookup (conf, "gpg", "keyserver", &comp, &opt)
+        && opt->value && opt->value->value.string && getenv ("GNUPGHOME"))
+      {
+        char *fname;
+
+        fprintf (stderr, " gpg.conf ");
+        fname = malloc (strlen (getenv ("GNUPGHOME")) + 10);
+        test (fname);
+        sprintf (fname, "%s/gpg.conf", getenv ("GNUPGHOME"));
+        if (!edit_file (fname, opt->value->value.string, "hkps://ext.example"))
+          {
+            gpgme_conf_release (conf);
+            err = gpgme_op_conf_load (ctx, &conf);
+            fail_if_err (err);
+            test (lookup (conf, "gpg", "keyserver", &comp, &opt));
+            test (opt->value && opt->value->value.string);
+            test (!strcmp (opt->value->value.string, "hkps://ext.example"));
+            fprintf (stderr, ".");
+          }
+        free (fname);
+      }
+  }
   fprintf (stderr, "\n");
 
   gpgme_conf_release (conf);
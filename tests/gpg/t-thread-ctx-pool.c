@@ -0,0 +1,122 @@
+/* t-thread-ctx-pool.c - Regression test.
+ * Copyright (C) 2026 g10 Code GmbH
+ *
+ * This file is part of GPGME.
+ *
+ * GPGME is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * GPGME is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, see <https://gnu.org/licenses/>.
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <gpgme.h>
+
+#include <pthread.h>
+
+#include "t-support.h"
+
+#define THREAD_COUNT 10
+#define ROUNDS 5
+
+static gpgme_ctx_pool_t pool;
+
+void *
+start_keylist (void *arg)
+{
+  gpgme_error_t err;
+  gpgme_ctx_t ctx;
+  gpgme_key_t key;
+  int i;
+
+  (void) arg;
+  for (i = 0; i < ROUNDS; i++)
+    {
+      err = gpgme_ctx_pool_get (pool, &ctx);
+      fail_if_err (err);
+
+      if (!gpgme_get_armor (ctx)
+          || gpgme_get_keylist_mode (ctx) != GPGME_KEYLIST_MODE_SIGS)
+        {
+          fprintf (stderr, "%s:%i: pooled context not configured\n",
+                   __FILE__, __LINE__);
+          exit (1);
+        }
+
+      /* Modify the context; the pool has to reset this.  */
+      gpgme_set_armor (ctx, 0);
+      gpgme_set_keylist_mode (ctx, GPGME_KEYLIST_MODE_LOCAL);
+
+      err = gpgme_op_keylist_start (ctx, NULL, 0);
+      fail_if_err (err);
+      while (!(err = gpgme_op_keylist_next (ctx, &key)))
+        gpgme_key_unref (key);
+      if (gpgme_err_code (err) != GPG_ERR_EOF)
+        fail_if_err (err);
+      if (!gpgme_op_keylist_result (ctx))
+        {
+          fprintf (stderr, "%s:%i: no keylist result\n", __FILE__, __LINE__);
+          exit (1);
+        }
+
+      gpgme_ctx_pool_put (pool, ctx);
+    }
+
+  return NULL;
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  gpgme_error_t err;
+  gpgme_ctx_t templ;
+  int i;
+  pthread_t keylist_threads[THREAD_COUNT];
+
+  init_gpgme (GPGME_PROTOCOL_OpenPGP);
+
+  (void)argc;
+  (void)argv;
+
+  err = gpgme_new (&templ);
+  fail_if_err (err);
+  gpgme_set_armor (templ, 1);
+  err = gpgme_set_keylist_mode (templ, GPGME_KEYLIST_MODE_SIGS);
+  fail_if_err (err);
+
+  err = gpgme_ctx_pool_new (&pool, templ, THREAD_COUNT / 2);
+  fail_if_err (err);
+  gpgme_release (templ);
+
+  for (i = 0; i < THREAD_COUNT; i++)
+    {
+      if (pthread_create (&keylist_threads[i], NULL, start_keylist, NULL))
+        {
+          fprintf (stderr, "%s:%i: failed to create threads \n",
+                   __FILE__, __LINE__);
+          exit (1);
+        }
+    }
+  for (i = 0; i < THREAD_COUNT; i++)
+    pthread_join (keylist_threads[i], NULL);
+
+  gpgme_ctx_pool_release (pool);
+  return 0;
+}
@@ -141,6 +141,7 @@ main (void)
   gpgme_error_t err;
   gpgme_data_t sig, text;
   gpgme_verify_result_t result;
+  int i;
 
   init_gpgme (GPGME_PROTOCOL_CMS);
 
@@ -177,6 +178,35 @@ main (void)
 
   show_auditlog (ctx);
 
+  /* Checking several messages in a row.  The gpgsm server is kept
+     running and only reset between the operations, so no process may
+     be spawned.  */
+  for (i = 0; i < 10; i++)
+    {
+      gpgme_data_release (text);
+      err = gpgme_data_new_from_mem (&text, (i & 1)? test_text1f : test_text1,
+                                     strlen (test_text1), 0);
+      fail_if_err (err);
+      gpgme_data_seek (sig, 0, SEEK_SET);
+      err = gpgme_op_verify (ctx, sig, text, NULL);
+      fail_if_err (err);
+      if (gpgme_op_stats (ctx)->spawns)
+        {
+          fprintf (stderr, "%s:%i: gpgsm was restarted\n",
+                   __FILE__, __LINE__);
+          got_errors = 1;
+        }
+      result = gpgme_op_verify_result (ctx);
+      if (i & 1)
+        check_result (result, GPGME_SIGSUM_RED,
+                      "3CF405464F66ED4A7DF45BBDD1E4282E33BDB76E",
+                      GPG_ERR_BAD_SIGNATURE, GPGME_VALIDITY_UNKNOWN);
+      else
+        check_result (result, GPGME_SIGSUM_VALID | GPGME_SIGSUM_GREEN,
+                      "3CF405464F66ED4A7DF45BBDD1E4282E33BDB76E",
+                      GPG_ERR_NO_ERROR, GPGME_VALIDITY_FULL);
+    }
+
   gpgme_data_release (text);
   gpgme_data_release (sig);
   gpgme_release (ctx);
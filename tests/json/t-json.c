@@ -40,7 +40,7 @@ static const char*tests[] = { "t-config", "t-version",
     "t-keylist", "t-keylist-secret", "t-decrypt", "t-config-opt",
     "t-encrypt", "t-encrypt-sign", "t-sign", "t-verify",
     "t-decrypt-verify", "t-export", "t-createkey",
-    "t-export-secret-info", "t-chunking", "t-sig-notations",
+    "t-export-secret-info", "t-chunking", "t-sig-notations", "t-batch",
     /* For these two the order is important
      * as t-import imports the deleted key from t-delete */
     "t-delete", "t-import",
@@ -90,6 +90,7 @@ show_usage (int ex)
          "  --ignore-mdc-error              allow decryption of legacy data\n"
          "  --unwrap         remove only the encryption layer\n"
          "  --diagnostics    print diagnostics\n"
+         "  --stats          print operation statistics\n"
          , stderr);
   exit (ex);
 }
@@ -115,6 +116,7 @@ main (int argc, char **argv)
   int ignore_mdc_error = 0;
   int raw_output = 0;
   int diagnostics = 0;
+  int print_stats = 0;
 
   if (argc)
     { argc--; argv++; }
@@ -185,6 +187,11 @@ main (int argc, char **argv)
           diagnostics = 1;
           argc--; argv++;
         }
+      else if (!strcmp (*argv, "--stats"))
+        {
+          print_stats = 1;
+          argc--; argv++;
+        }
       else if (!strcmp (*argv, "--unwrap"))
         {
           flags |= GPGME_DECRYPT_UNWRAP;
@@ -292,6 +299,22 @@ main (int argc, char **argv)
   err = gpgme_op_decrypt_ext (ctx, flags, in, out);
   result = gpgme_op_decrypt_result (ctx);
 
+  if (print_stats)
+    {
+      gpgme_op_stats_t stats = gpgme_op_stats (ctx);
+
+      fprintf (stderr, PGM ": bytes in/out: %llu/%llu\n"
+               PGM ": read/write calls: %lu/%lu\n"
+               PGM ": wakeups: %lu\n"
+               PGM ": status lines: %lu\n"
+               PGM ": spawns: %lu (%llu us)\n"
+               PGM ": total: %llu us\n",
+               stats->bytes_in, stats->bytes_out,
+               stats->read_calls, stats->write_calls,
+               stats->wakeups, stats->status_lines,
+               stats->spawns, stats->spawn_usec, stats->total_usec);
+    }
+
   if (diagnostics)
     {
       gpgme_data_t diag;
@@ -0,0 +1,240 @@
+/* run-spawn.c  - Measure the latency of spawning engines
+ * Copyright (C) 2026 g10 Code GmbH
+ *
+ * This file is part of GPGME.
+ *
+ * GPGME is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * GPGME is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, see <https://gnu.org/licenses/>.
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+/* We need to include config.h so that we know whether we are building
+   with large file system (LFS) support. */
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+
+#include <gpgme.h>
+
+#define PGM "run-spawn"
+
+#include "run-support.h"
+
+
+static int verbose;
+
+
+static int
+show_usage (int ex)
+{
+  fputs ("usage: " PGM " [options] [PROGRAM]\n\n"
+         "Measure the time to run PROGRAM (default: /bin/true) via the\n"
+         "spawn engine while the process has a given resident size.\n\n"
+         "Options:\n"
+         "  --verbose        run in verbose mode\n"
+         "  --rss N          grow the process by N MiB before spawning\n"
+         "  --count N        spawn N times (default: 100)\n"
+         "  --fork           also measure a plain fork/exec/waitpid\n"
+         "  --detached       spawn with GPGME_SPAWN_DETACHED\n"
+         , stderr);
+  exit (ex);
+}
+
+
+static double
+now (void)
+{
+  struct timeval tv;
+
+  gettimeofday (&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+
+/* Allocate and touch MIB MiB so that they count towards the resident
+   size and need to be mapped into a forked child.  */
+static void
+grow_rss (unsigned long mib)
+{
+  char *p;
+  size_t n;
+
+  if (!mib)
+    return;
+  n = mib * 1024 * 1024;
+  p = malloc (n);
+  if (!p)
+    {
+      fprintf (stderr, PGM ": can't allocate %lu MiB\n", mib);
+      exit (1);
+    }
+  memset (p, 1, n);
+  /* P is deliberately not freed.  */
+}
+
+
+static double
+measure_gpgme (const char *program, int count, unsigned int flags)
+{
+  gpgme_error_t err;
+  gpgme_ctx_t ctx;
+  const char *argv[2];
+  double start;
+  int i;
+
+  argv[0] = "";
+  argv[1] = NULL;
+
+  err = gpgme_new (&ctx);
+  fail_if_err (err);
+  err = gpgme_set_protocol (ctx, GPGME_PROTOCOL_SPAWN);
+  fail_if_err (err);
+
+  start = now ();
+  for (i = 0; i < count; i++)
+    {
+      err = gpgme_op_spawn (ctx, program, argv, NULL, NULL, NULL, flags);
+      fail_if_err (err);
+    }
+  start = now () - start;
+
+  /* A detached program must not be our child.  */
+  if ((flags & GPGME_SPAWN_DETACHED)
+      && (waitpid (-1, NULL, WNOHANG) != -1 || errno != ECHILD))
+    {
+      fprintf (stderr, PGM ": detached program is a child process\n");
+      exit (1);
+    }
+
+  gpgme_release (ctx);
+  return start;
+}
+
+
+static double
+measure_fork (const char *program, int count)
+{
+  double start;
+  pid_t pid;
+  int i;
+
+  start = now ();
+  for (i = 0; i < count; i++)
+    {
+      pid = fork ();
+      if (pid == -1)
+        {
+          perror (PGM ": fork");
+          exit (1);
+        }
+      if (!pid)
+        {
+          execl (program, program, (char *)NULL);
+          _exit (127);
+        }
+      waitpid (pid, NULL, 0);
+    }
+  return now () - start;
+}
+
+
+int
+main (int argc, char **argv)
+{
+  int last_argc = -1;
+  unsigned long rss = 0;
+  int count = 100;
+  int with_fork = 0;
+  unsigned int flags = 0;
+  const char *program = "/bin/true";
+  double elapsed;
+
+  if (argc)
+    { argc--; argv++; }
+
+  while (argc && last_argc != argc )
+    {
+      last_argc = argc;
+      if (!strcmp (*argv, "--"))
+        {
+          argc--; argv++;
+          break;
+        }
+      else if (!strcmp (*argv, "--help"))
+        show_usage (0);
+      else if (!strcmp (*argv, "--verbose"))
+        {
+          verbose = 1;
+          argc--; argv++;
+        }
+      else if (!strcmp (*argv, "--rss"))
+        {
+          argc--; argv++;
+          if (!argc)
+            show_usage (1);
+          rss = strtoul (*argv, NULL, 10);
+          argc--; argv++;
+        }
+      else if (!strcmp (*argv, "--count"))
+        {
+          argc--; argv++;
+          if (!argc)
+            show_usage (1);
+          count = atoi (*argv);
+          argc--; argv++;
+        }
+      else if (!strcmp (*argv, "--fork"))
+        {
+          with_fork = 1;
+          argc--; argv++;
+        }
+      else if (!strcmp (*argv, "--detached"))
+        {
+          flags |= GPGME_SPAWN_DETACHED;
+          argc--; argv++;
+        }
+      else if (!strncmp (*argv, "--", 2))
+        show_usage (1);
+    }
+
+  if (argc > 1 || count < 1)
+    show_usage (1);
+  if (argc)
+    program = *argv;
+
+  init_gpgme (GPGME_PROTOCOL_SPAWN);
+  grow_rss (rss);
+  if (verbose)
+    fprintf (stderr, PGM ": spawning '%s' %d times with %lu MiB extra\n",
+             program, count, rss);
+
+  elapsed = measure_gpgme (program, count, flags);
+  printf ("rss=%lu MiB  gpgme:  %8.1f us/spawn\n",
+          rss, elapsed * 1e6 / count);
+  if (with_fork)
+    {
+      elapsed = measure_fork (program, count);
+      printf ("rss=%lu MiB  fork:   %8.1f us/spawn\n",
+              rss, elapsed * 1e6 / count);
+    }
+
+  return 0;
+}
@@ -0,0 +1,271 @@
+/* t-replay.c - Regression test for the replay engine.
+ * Copyright (C) 2026 g10 Code GmbH
+ *
+ * This file is part of GPGME.
+ *
+ * GPGME is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2.1 of
+ * the License, or (at your option) any later version.
+ *
+ * GPGME is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not, see <https://gnu.org/licenses/>.
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <gpgme.h>
+
+#define PGM "t-replay"
+
+#include "run-support.h"
+
+
+#define test(expr)                                              \
+  do                                                            \
+    {                                                           \
+      if (!(expr))                                              \
+        {                                                       \
+          fprintf (stderr, "%s:%d: test '%s' failed\n",         \
+                   __FILE__, __LINE__, #expr);                  \
+          exit (1);                                             \
+        }                                                       \
+    }                                                           \
+  while (0)
+
+
+static gpgme_ctx_t
+new_replay_ctx (const char *fname)
+{
+  gpgme_error_t err;
+  gpgme_ctx_t ctx;
+  char *transcript = make_filename (fname);
+
+  err = gpgme_new (&ctx);
+  fail_if_err (err);
+  err = gpgme_set_ctx_flag (ctx, "replay", transcript);
+  fail_if_err (err);
+  test (!strcmp (gpgme_get_ctx_flag (ctx, "replay"), transcript));
+  free (transcript);
+  return ctx;
+}
+
+
+/* Check a decryption with the replay engine paced as given by PACE,
+ * which may be NULL.  */
+static void
+check_decrypt (const char *pace)
+{
+  gpgme_error_t err;
+  gpgme_ctx_t ctx;
+  gpgme_data_t in, out;
+  gpgme_decrypt_result_t result;
+  char *plain;
+  size_t len;
+  int i;
+
+  ctx = new_replay_ctx ("t-replay-decrypt.trans");
+  if (pace)
+    {
+      err = gpgme_set_ctx_flag (ctx, "replay-pace", pace);
+      fail_if_err (err);
+      test (!strcmp (gpgme_get_ctx_flag (ctx, "replay-pace"), pace));
+    }
+
+  /* Run twice to check that the engine may be reused.  */
+  for (i = 0; i < 2; i++)
+    {
+      err = gpgme_data_new_from_mem (&in, "some ciphertext", 15, 0);
+      fail_if_err (err);
+      err = gpgme_data_new (&out);
+      fail_if_err (err);
+
+      err = gpgme_op_decrypt (ctx, in, out);
+      fail_if_err (err);
+      result = gpgme_op_decrypt_result (ctx);
+      test (result);
+      test (result->file_name && !strcmp (result->file_name, "geheim.txt"));
+      test (result->recipients
+            && !strcmp (result->recipients->keyid, "6AE6D7EE46A871F8"));
+      test (!result->unsupported_algorithm);
+
+      plain = gpgme_data_release_and_get_mem (out, &len);
+      test (len == 22 && !memcmp (plain, "Hallo Leute!\n50% off.\n", 22));
+      gpgme_free (plain);
+      gpgme_data_release (in);
+    }
+
+  gpgme_release (ctx);
+}
+
+
+static void
+check_keylist (const char *pace)
+{
+  gpgme_error_t err;
+  gpgme_ctx_t ctx;
+  gpgme_key_t key;
+  int count = 0;
+
+  ctx = new_replay_ctx ("t-replay-keylist.trans");
+  if (pace)
+    {
+      err = gpgme_set_ctx_flag (ctx, "replay-pace", pace);
+      fail_if_err (err);
+    }
+
+  err = gpgme_op_keylist_start (ctx, NULL, 0);
+  fail_if_err (err);
+  while (!(err = gpgme_op_keylist_next (ctx, &key)))
+    {
+      if (!count)
+        {
+          test (!strcmp (key->fpr,
+                         "A0FF4590BB6122EDEF6E3C542D727CC768697734"));
+          test (key->subkeys->next && key->subkeys->next->can_encrypt);
+          test (key->uids && key->uids->next);
+          test (!strcmp (key->uids->email, "alfa@example.net"));
+          test (!strcmp (key->uids->next->uid,
+                         "Alice : Test (demo key)"));
+        }
+      else
+        test (!strcmp (key->uids->name, "Bob"));
+      count++;
+      gpgme_key_unref (key);
+    }
+  test (gpg_err_code (err) == GPG_ERR_EOF);
+  test (count == 2);
+
+  gpgme_release (ctx);
+}
+
+
+/* Check that the engine can't be switched under a running
+ * operation.  */
+static void
+check_busy (void)
+{
+  gpgme_error_t err, op_err;
+  gpgme_ctx_t ctx;
+  gpgme_data_t in, out;
+
+  ctx = new_replay_ctx ("t-replay-decrypt.trans");
+  err = gpgme_data_new_from_mem (&in, "some ciphertext", 15, 0);
+  fail_if_err (err);
+  err = gpgme_data_new (&out);
+  fail_if_err (err);
+
+  err = gpgme_op_decrypt_start (ctx, in, out);
+  fail_if_err (err);
+  err = gpgme_set_ctx_flag (ctx, "replay", "");
+  test (gpg_err_code (err) == GPG_ERR_EBUSY);
+  test (gpgme_get_ctx_flag (ctx, "replay")
+        && *gpgme_get_ctx_flag (ctx, "replay"));
+
+  test (gpgme_wait (ctx, &op_err, 1) == ctx);
+  fail_if_err (op_err);
+  err = gpgme_set_ctx_flag (ctx, "replay", "");
+  fail_if_err (err);
+
+  gpgme_data_release (out);
+  gpgme_data_release (in);
+  gpgme_release (ctx);
+}
+
+
+#ifndef HAVE_W32_SYSTEM
+/* Check that a paced operation can be canceled while the engine waits
+ * for its latency to pass.  */
+static void
+check_cancel (void)
+{
+  gpgme_error_t err;
+  gpgme_ctx_t ctx;
+  gpgme_data_t in, out;
+  time_t start;
+
+  ctx = new_replay_ctx ("t-replay-decrypt.trans");
+  err = gpgme_set_ctx_flag (ctx, "replay-pace", "60000000");
+  fail_if_err (err);
+  err = gpgme_data_new_from_mem (&in, "some ciphertext", 15, 0);
+  fail_if_err (err);
+  err = gpgme_data_new (&out);
+  fail_if_err (err);
+
+  start = time (NULL);
+  err = gpgme_op_decrypt_start (ctx, in, out);
+  fail_if_err (err);
+  err = gpgme_cancel (ctx);
+  fail_if_err (err);
+  gpgme_release (ctx);
+  test (time (NULL) - start < 30);
+
+  gpgme_data_release (out);
+  gpgme_data_release (in);
+}
+#endif
+
+
+static void
+check_conf (void)
+{
+  gpgme_error_t err;
+  gpgme_ctx_t ctx;
+  gpgme_conf_comp_t conf;
+  gpgme_conf_opt_t opt;
+
+  ctx = new_replay_ctx ("t-replay-conf.trans");
+  err = gpgme_set_protocol (ctx, GPGME_PROTOCOL_GPGCONF);
+  fail_if_err (err);
+  err = gpgme_op_conf_load (ctx, &conf);
+  fail_if_err (err);
+
+  test (conf && !strcmp (conf->name, "gpg"));
+  test (conf->next && !strcmp (conf->next->name, "gpg-agent"));
+  test (!conf->next->next);
+
+  for (opt = conf->options; opt; opt = opt->next)
+    if (!strcmp (opt->name, "keyserver"))
+      break;
+  test (opt && opt->value && opt->value->value.string);
+  test (!strcmp (opt->value->value.string, "hkps://keys.example.org"));
+  test (conf->next->options && conf->next->options->next
+        && !strcmp (conf->next->options->next->name, "quiet"));
+
+  gpgme_conf_release (conf);
+  gpgme_release (ctx);
+}
+
+
+int
+main (void)
+{
+  init_gpgme_basic ();
+
+  check_decrypt (NULL);
+  check_keylist (NULL);
+  check_busy ();
+  check_conf ();
+
+#ifndef HAVE_W32_SYSTEM
+  /* A latency of 1ms and a rate of 100 kB/s.  */
+  check_decrypt ("1000,100000");
+  check_keylist ("1000,100000");
+  check_cancel ();
+#endif
+
+  return 0;
+}